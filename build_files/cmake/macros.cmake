@@ -598,6 +598,41 @@ macro(get_sse_flags
   endif()
 endmacro()
 
+# Flags for source files that are compiled for AVX2 and AVX-512 in addition to the baseline,
+# the code is then selected at run-time. Empty when not supported by the compiler or platform.
+# Only enable the extensions checked by `BLI_cpu_support_avx2` and `BLI_cpu_support_avx512`,
+# `-march=x86-64-v3` would also allow BMI, LZCNT, MOVBE and F16C instructions.
+macro(get_avx_flags
+  _avx2_flags _avx512_flags)
+
+  set(${_avx2_flags})
+  set(${_avx512_flags})
+  if(CMAKE_SYSTEM_PROCESSOR MATCHES "(x86_64)|(AMD64)" OR CMAKE_OSX_ARCHITECTURES MATCHES x86_64)
+    if((CMAKE_C_COMPILER_ID STREQUAL "GNU") OR (CMAKE_C_COMPILER_ID MATCHES "Clang"))
+      include(CheckCXXCompilerFlag)
+      set(_avx2_test_flags "-mavx2 -mfma")
+      set(_avx512_test_flags
+        "${_avx2_test_flags} -mavx512f -mavx512bw -mavx512cd -mavx512dq -mavx512vl"
+      )
+      check_cxx_compiler_flag("${_avx2_test_flags}" _has_avx2_flags)
+      check_cxx_compiler_flag("${_avx512_test_flags}" _has_avx512_flags)
+      if(_has_avx2_flags)
+        set(${_avx2_flags} "${_avx2_test_flags}")
+      endif()
+      if(_has_avx512_flags)
+        set(${_avx512_flags} "${_avx512_test_flags}")
+      endif()
+      unset(_avx2_test_flags)
+      unset(_avx512_test_flags)
+      unset(_has_avx2_flags)
+      unset(_has_avx512_flags)
+    elseif(MSVC)
+      set(${_avx2_flags} "/arch:AVX2")
+      set(${_avx512_flags} "/arch:AVX512")
+    endif()
+  endif()
+endmacro()
+
 macro(test_neon_support)
   if(NOT DEFINED SUPPORTS_NEON_BUILD)
     include(CheckCXXSourceCompiles)
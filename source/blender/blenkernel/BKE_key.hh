@@ -37,6 +37,15 @@ Key *BKE_key_add(Main *bmain, ID *id);
  * which is a valid assumption for the places it's currently being called.
  */
 void BKE_key_sort(Key *key);
+/**
+ * Copy the settings of the key and all its key-blocks (influence, interpolation, relative key,
+ * vertex group, flags, ...) from \a key_src to \a key_dst, leaving the shape data untouched.
+ *
+ * Used to update an evaluated copy without duplicating all shape data when only settings changed.
+ * \return false when the keys don't have the same blocks with the same number of elements, in
+ * which case nothing is copied.
+ */
+bool BKE_key_copy_settings(Key *key_dst, const Key *key_src);
 
 void key_curve_position_weights(float t, float data[4], KeyInterpolationType type);
 /**
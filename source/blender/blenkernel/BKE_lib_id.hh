@@ -86,6 +86,14 @@ struct ID_Runtime {
    */
   Depsgraph *depsgraph = nullptr;
 
+  /**
+   * Changes every time the depsgraph copies the original data-block into this evaluated copy, and
+   * is unique across all depsgraphs. Zero for data-blocks that are not copied-on-eval. Evaluated
+   * data derived from this copy can be reused as long as the version and any values changed by
+   * animation in-place are the same.
+   */
+  uint64_t eval_copy_version = 0;
+
   /**
    * This data is only allocated & used during the readfile process. After that, the memory is
    * freed and the pointer set to `nullptr`.
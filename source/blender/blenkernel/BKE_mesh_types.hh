@@ -131,6 +131,29 @@ struct TrianglesCache {
   void tag_dirty();
 };
 
+/**
+ * Keeps a tree available when only the positions of a mesh change (e.g. deformation every frame),
+ * so it can be refitted rather than built from scratch.
+ */
+struct BVHRefitCache {
+  Mutex mutex;
+  /** The most recently built or refitted tree, also referenced by the corresponding cache. */
+  std::shared_ptr<const BVHTree> tree;
+  /** #BLI_bvhtree_sah_cost of the tree when it was last built from scratch. */
+  float sah_cost_built = 0.0f;
+};
+
+/**
+ * The trees that are refitted for the evaluated meshes of an object, owned by the evaluated
+ * object, see #ObjectRuntime::bvh_refit. Other meshes, like original meshes or meshes used by
+ * several objects, always build their trees from scratch, because refitting a tree that was built
+ * for unrelated positions would make it switch between refitting and rebuilding.
+ */
+struct BVHRefitCaches {
+  BVHRefitCache verts;
+  BVHRefitCache corner_tris;
+};
+
 struct MeshGroup {
   /** Range of unique vertices in reordered mesh. */
   IndexRange unique_verts;
@@ -197,15 +220,20 @@ struct MeshRuntime {
   /** Cache for triangle to original face index map, accessed with #Mesh::corner_tri_faces(). */
   SharedCache<Array<int>> corner_tri_faces_cache;
 
-  SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_verts;
+  SharedCache<std::shared_ptr<const BVHTree>> bvh_cache_verts;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_edges;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_faces;
-  SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_corner_tris;
+  SharedCache<std::shared_ptr<const BVHTree>> bvh_cache_corner_tris;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_corner_tris_no_hidden;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_loose_verts;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_loose_verts_no_hidden;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_loose_edges;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_loose_edges_no_hidden;
+  /**
+   * Trees of #bvh_cache_verts and #bvh_cache_corner_tris from the previous evaluation of the
+   * object that this mesh was evaluated for. Null for all other meshes. Not copied with the mesh.
+   */
+  std::shared_ptr<BVHRefitCaches> bvh_refit;
 
   SharedCache<std::optional<int>> max_material_index;
   SharedCache<VectorSet<int>> used_material_indices;
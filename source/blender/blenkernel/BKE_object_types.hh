@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <optional>
 
 #include "BLI_array.hh"
@@ -28,6 +29,7 @@ struct SculptSession;
 
 namespace bke {
 
+struct BVHRefitCaches;
 struct GeometrySet;
 
 struct ObjectRuntime {
@@ -94,6 +96,13 @@ struct ObjectRuntime {
    */
   uint16_t contained_geometry_types = 0;
 
+  /**
+   * BVH trees of the last evaluated mesh that this object owns. They are passed on to the next
+   * evaluated mesh, so that they can be refitted when only positions changed. Kept across
+   * evaluations, and released when the object doesn't own its evaluated mesh anymore.
+   */
+  std::shared_ptr<BVHRefitCaches> bvh_refit;
+
   /**
    * Mesh structure created during object evaluation.
    * It has deformation only modifiers applied on it.
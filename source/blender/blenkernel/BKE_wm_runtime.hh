@@ -56,6 +56,12 @@ struct WindowManagerRuntime {
   /** Indicates whether interface is locked for user interaction. */
   bool is_interface_locked = false;
 
+  /**
+   * Data was modified (or changed by undo/redo) since the last auto-save file was written,
+   * when false, writing a new auto-save file can be skipped.
+   */
+  bool autosave_has_changes = false;
+
   /** Information and error reports. */
   ReportList reports;
 
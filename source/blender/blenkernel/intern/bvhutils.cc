@@ -639,6 +639,60 @@ static BitVector<> loose_edges_no_hidden_mask_get(const Mesh &mesh)
   return edge_mask;
 }
 
+/**
+ * Refitted trees are rebuilt once their cost grew by this factor compared to the cost right after
+ * building, since refitting does not change the topology of the tree, which may become a poor fit
+ * for heavily deformed geometry.
+ */
+static constexpr float BVH_REFIT_SAH_COST_FACTOR_MAX = 1.5f;
+
+/**
+ * Refit a copy of the tree from a previous state of the mesh with the same topology if it exists,
+ * or build a new tree otherwise. See #BVHRefitCache. Without a refit cache, the tree is always
+ * built from scratch.
+ */
+static std::shared_ptr<const BVHTree> bvhtree_refit_or_build(
+    BVHRefitCache *refit_cache_ptr,
+    const int leafs_num,
+    const int points_num,
+    const BVHTree_RefitCallback refit_fn,
+    const FunctionRef<std::unique_ptr<BVHTree, BVHTreeDeleter>()> build_fn)
+{
+  if (refit_cache_ptr == nullptr) {
+    return build_fn();
+  }
+  BVHRefitCache &refit_cache = *refit_cache_ptr;
+  std::shared_ptr<const BVHTree> tree_prev;
+  float sah_cost_built;
+  {
+    std::lock_guard lock{refit_cache.mutex};
+    tree_prev = refit_cache.tree;
+    sah_cost_built = refit_cache.sah_cost_built;
+  }
+
+  if (tree_prev && BLI_bvhtree_get_len(tree_prev.get()) == leafs_num) {
+    /* The previous tree may still be used by other meshes, so it can't be changed in place. */
+    std::unique_ptr<BVHTree, BVHTreeDeleter> tree(BLI_bvhtree_copy(tree_prev.get()));
+    BLI_bvhtree_refit(*tree, points_num, refit_fn);
+    if (BLI_bvhtree_sah_cost(*tree) <= sah_cost_built * BVH_REFIT_SAH_COST_FACTOR_MAX) {
+      std::shared_ptr<const BVHTree> result = std::move(tree);
+      std::lock_guard lock{refit_cache.mutex};
+      refit_cache.tree = result;
+      return result;
+    }
+  }
+
+  std::shared_ptr<const BVHTree> result = build_fn();
+  if (!result) {
+    return {};
+  }
+  const float sah_cost = BLI_bvhtree_sah_cost(*result);
+  std::lock_guard lock{refit_cache.mutex};
+  refit_cache.tree = result;
+  refit_cache.sah_cost_built = sah_cost;
+  return result;
+}
+
 }  // namespace bke
 
 bke::BVHTreeFromMesh Mesh::bvh_loose_verts() const
@@ -672,8 +726,13 @@ bke::BVHTreeFromMesh Mesh::bvh_verts() const
 {
   using namespace blender::bke;
   const Span<float3> positions = this->vert_positions();
-  this->runtime->bvh_cache_verts.ensure([&](std::unique_ptr<BVHTree, BVHTreeDeleter> &data) {
-    data = create_tree_from_verts(positions, positions.index_range());
+  this->runtime->bvh_cache_verts.ensure([&](std::shared_ptr<const BVHTree> &data) {
+    data = bvhtree_refit_or_build(
+        this->runtime->bvh_refit ? &this->runtime->bvh_refit->verts : nullptr,
+        positions.size(),
+        1,
+        [&](const int vert, MutableSpan<float3> r_points) { r_points[0] = positions[vert]; },
+        [&]() { return create_tree_from_verts(positions, positions.index_range()); });
   });
   return create_verts_tree_data(this->runtime->bvh_cache_verts.data().get(), positions);
 }
@@ -765,8 +824,17 @@ bke::BVHTreeFromMesh Mesh::bvh_corner_tris() const
   const Span<float3> positions = this->vert_positions();
   const Span<int> corner_verts = this->corner_verts();
   const Span<int3> corner_tris = this->corner_tris();
-  this->runtime->bvh_cache_corner_tris.ensure([&](std::unique_ptr<BVHTree, BVHTreeDeleter> &data) {
-    data = create_tree_from_tris(positions, corner_verts, corner_tris);
+  this->runtime->bvh_cache_corner_tris.ensure([&](std::shared_ptr<const BVHTree> &data) {
+    data = bvhtree_refit_or_build(
+        this->runtime->bvh_refit ? &this->runtime->bvh_refit->corner_tris : nullptr,
+        corner_tris.size(),
+        3,
+        [&](const int tri, MutableSpan<float3> r_points) {
+          r_points[0] = positions[corner_verts[corner_tris[tri][0]]];
+          r_points[1] = positions[corner_verts[corner_tris[tri][1]]];
+          r_points[2] = positions[corner_verts[corner_tris[tri][2]]];
+        },
+        [&]() { return create_tree_from_tris(positions, corner_verts, corner_tris); });
   });
   return create_tris_tree_data(
       this->runtime->bvh_cache_corner_tris.data().get(), positions, corner_verts, corner_tris);
@@ -107,8 +107,9 @@ BVHTree *bvhtree_build_from_mvert(const float (*positions)[3],
     BLI_bvhtree_insert(tree, i, co[0], 3);
   }
 
-  /* balance tree */
-  BLI_bvhtree_balance(tree);
+  /* Balance tree. The collision modifier builds it on the first frame and refits it on all later
+   * frames, so use the slower but better SAH build. */
+  BLI_bvhtree_balance_ex(tree, BVH_BALANCE_SAH, nullptr);
 
   return tree;
 }
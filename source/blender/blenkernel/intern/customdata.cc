@@ -22,6 +22,7 @@
 #include "DNA_modifier_enums.h"
 #include "DNA_userdef_types.h"
 
+#include "BLI_array_utils.hh"
 #include "BLI_bit_vector.hh"
 #include "BLI_bitmap.h"
 #include "BLI_index_range.hh"
@@ -2868,8 +2869,9 @@ static CustomDataLayer *customData_add_layer__internal(
             type_info.set_default_value(new_layer.data, totelem);
           }
           else {
-            /* Alternatively, #MEM_calloc_arrayN is faster, but has no aligned version. */
-            memset(new_layer.data, 0, size_in_bytes);
+            /* Alternatively, #MEM_calloc_arrayN is faster, but has no aligned version. Clearing
+             * the data also decides which NUMA nodes its pages are placed on. */
+            array_utils::fill_zero_numa(new_layer.data, size_in_bytes);
           }
         }
         break;
@@ -1429,6 +1429,34 @@ void BKE_keyblock_copy_settings(KeyBlock *kb_dst, const KeyBlock *kb_src)
   kb_dst->slidermax = kb_src->slidermax;
 }
 
+bool BKE_key_copy_settings(Key *key_dst, const Key *key_src)
+{
+  if (key_dst->totkey != key_src->totkey || key_dst->elemsize != key_src->elemsize) {
+    return false;
+  }
+  const KeyBlock *kb_src = static_cast<const KeyBlock *>(key_src->block.first);
+  for (const KeyBlock &kb_dst : key_dst->block) {
+    if (kb_src == nullptr || kb_dst.totelem != kb_src->totelem || kb_dst.uid != kb_src->uid) {
+      return false;
+    }
+    kb_src = kb_src->next;
+  }
+  if (kb_src != nullptr) {
+    return false;
+  }
+
+  key_dst->type = key_src->type;
+  key_dst->flag = key_src->flag;
+  key_dst->ctime = key_src->ctime;
+  kb_src = static_cast<const KeyBlock *>(key_src->block.first);
+  for (KeyBlock &kb_dst : key_dst->block) {
+    BKE_keyblock_copy_settings(&kb_dst, kb_src);
+    kb_dst.flag = kb_src->flag;
+    kb_src = kb_src->next;
+  }
+  return true;
+}
+
 std::optional<std::string> BKE_keyblock_curval_rnapath_get(const Key *key, const KeyBlock *kb)
 {
   if (ELEM(nullptr, key, kb)) {
@@ -6,6 +6,8 @@
  * \ingroup bke
  */
 
+#include <optional>
+
 #include "DNA_cloth_types.h"
 #include "DNA_customdata_types.h"
 #include "DNA_key_types.h"
@@ -18,9 +20,11 @@
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_vector_types.hh"
+#include "BLI_memory_cache.hh"
 #include "BLI_span.hh"
 #include "BLI_string.h"
 #include "BLI_task.hh"
+#include "BLI_time.h"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -45,6 +49,8 @@
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_query.hh"
 
+#include "mesh_eval_cache.hh"
+
 namespace blender::bke {
 
 /**
@@ -979,19 +985,56 @@ static void mesh_build_data(Depsgraph &depsgraph,
   }
 #endif
 
+  Mesh *mesh = id_cast<Mesh *>(ob.data);
   Mesh *mesh_eval = nullptr, *mesh_deform_eval = nullptr;
   GeometrySet *geometry_set_eval = nullptr;
-  mesh_calc_modifiers(depsgraph,
-                      scene,
-                      ob,
-                      true,
-                      need_mapping,
-                      dataMask,
-                      true,
-                      true,
-                      &mesh_deform_eval,
-                      &mesh_eval,
-                      &geometry_set_eval);
+  const std::optional<EvaluatedMeshKey> cache_key = evaluated_mesh_key_build(
+      depsgraph, scene, ob, dataMask, need_mapping);
+  const auto calc_modifiers = [&]() {
+    const double start_time = BLI_time_now_seconds();
+    mesh_calc_modifiers(depsgraph,
+                        scene,
+                        ob,
+                        true,
+                        need_mapping,
+                        dataMask,
+                        true,
+                        true,
+                        &mesh_deform_eval,
+                        &mesh_eval,
+                        &geometry_set_eval);
+    if (cache_key) {
+      evaluated_mesh_cache_eval_time_set(
+          depsgraph, *cache_key, BLI_time_now_seconds() - start_time);
+    }
+  };
+
+  if (cache_key && evaluated_mesh_cache_prepare(depsgraph, *cache_key)) {
+    bool is_computed = false;
+    const std::shared_ptr<const EvaluatedMeshValue> cached = memory_cache::get<EvaluatedMeshValue>(
+        *cache_key, [&]() {
+          calc_modifiers();
+          is_computed = true;
+          return evaluated_mesh_value_create(
+              ob, *mesh, *mesh_eval, mesh_deform_eval, *geometry_set_eval);
+        });
+    if (!is_computed) {
+      if (cached->mesh_final) {
+        mesh_eval = BKE_mesh_copy_for_eval(*cached->mesh_final);
+        if (cached->mesh_deform) {
+          mesh_deform_eval = BKE_mesh_copy_for_eval(*cached->mesh_deform);
+        }
+        geometry_set_eval = new GeometrySet(cached->geometry_set);
+        evaluated_mesh_value_restore_errors(*cached, ob);
+      }
+      else {
+        calc_modifiers();
+      }
+    }
+  }
+  else {
+    calc_modifiers();
+  }
 
   /* The modifier stack evaluation is storing result in mesh->runtime.mesh_eval, but this result
    * is not guaranteed to be owned by object.
@@ -999,10 +1042,21 @@ static void mesh_build_data(Depsgraph &depsgraph,
    * Check ownership now, since later on we can not go to a mesh owned by someone else via
    * object's runtime: this could cause access freed data on depsgraph destruction (mesh who owns
    * the final result might be freed prior to object). */
-  Mesh *mesh = id_cast<Mesh *>(ob.data);
   const bool is_mesh_eval_owned = (mesh_eval != mesh->runtime->mesh_eval);
   BKE_object_eval_assign_data(&ob, &mesh_eval->id, is_mesh_eval_owned);
 
+  /* Let the new mesh refit the BVH trees of the previous evaluation. A mesh that is shared with
+   * other objects builds its own trees. */
+  if (is_mesh_eval_owned) {
+    if (!ob.runtime->bvh_refit) {
+      ob.runtime->bvh_refit = std::make_shared<BVHRefitCaches>();
+    }
+    mesh_eval->runtime->bvh_refit = ob.runtime->bvh_refit;
+  }
+  else {
+    ob.runtime->bvh_refit.reset();
+  }
+
   /* Add the final mesh as a non-owning component to the geometry set. */
   MeshComponent &mesh_component = geometry_set_eval->get_component_for_write<MeshComponent>();
   mesh_component.replace(mesh_eval, GeometryOwnershipType::Editable);
@@ -1055,6 +1109,7 @@ static void editbmesh_build_data(Depsgraph &depsgraph,
   me_final->key = mesh->key;
 
   obedit.runtime->editmesh_eval_cage = me_cage;
+  obedit.runtime->bvh_refit.reset();
 
   obedit.runtime->last_data_mask = dataMask;
 }
@@ -0,0 +1,504 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <xxhash.h>
+
+#include "DNA_genfile.h"
+#include "DNA_key_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_sdna_types.h"
+#include "DNA_userdef_types.h"
+
+#include "BLI_array.hh"
+#include "BLI_listbase.h"
+#include "BLI_map.hh"
+#include "BLI_memory_counter.hh"
+#include "BLI_mutex.hh"
+#include "BLI_string.h"
+#include "BLI_string_ref.hh"
+
+#include "BKE_anim_data.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_types.hh"
+#include "BKE_modifier.hh"
+#include "BKE_object_types.hh"
+
+#include "DEG_depsgraph_query.hh"
+
+#include "MEM_guardedalloc.h"
+
+#include "mesh_eval_cache.hh"
+
+namespace blender::bke {
+
+/**
+ * Results of stacks that evaluate faster than this are neither stored nor looked up, because
+ * copying them into the cache costs about as much as evaluating them again.
+ */
+static constexpr double min_eval_time_to_cache = 0.001;
+
+void EvaluatedMeshKey::add_bytes(const void *data, const int64_t size)
+{
+  this->fingerprint.extend(Span(static_cast<const uint8_t *>(data), size));
+}
+
+uint64_t EvaluatedMeshKey::hash() const
+{
+  const uint64_t fingerprint_hash = XXH3_64bits(this->fingerprint.data(),
+                                                size_t(this->fingerprint.size()));
+  return get_default_hash(this->session_uid,
+                          this->versions[0],
+                          this->versions[1],
+                          this->versions[2],
+                          fingerprint_hash);
+}
+
+bool EvaluatedMeshKey::equal_to(const GenericKey &other) const
+{
+  if (const auto *other_typed = dynamic_cast<const EvaluatedMeshKey *>(&other)) {
+    return this->session_uid == other_typed->session_uid &&
+           this->versions == other_typed->versions &&
+           this->fingerprint.as_span() == other_typed->fingerprint.as_span();
+  }
+  return false;
+}
+
+std::unique_ptr<GenericKey> EvaluatedMeshKey::to_storable() const
+{
+  return std::make_unique<EvaluatedMeshKey>(*this);
+}
+
+EvaluatedMeshValue::~EvaluatedMeshValue()
+{
+  if (this->mesh_final) {
+    BKE_id_free(nullptr, this->mesh_final);
+  }
+  if (this->mesh_deform) {
+    BKE_id_free(nullptr, this->mesh_deform);
+  }
+}
+
+void EvaluatedMeshValue::count_memory(MemoryCounter &memory) const
+{
+  if (this->mesh_final) {
+    this->mesh_final->count_memory(memory);
+  }
+  if (this->mesh_deform) {
+    this->mesh_deform->count_memory(memory);
+  }
+  this->geometry_set.count_memory(memory);
+}
+
+bool evaluated_mesh_cache_is_enabled()
+{
+  return !USER_DEVELOPER_TOOL_TEST(&U, no_evaluated_mesh_cache);
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Modifier Settings
+ * \{ */
+
+/** Members that are written by the evaluation of the modifier, rather than by the user. */
+static bool dna_member_is_runtime(const StringRef name)
+{
+  return name.startswith("_pad") || ELEM(name, "runtime", "delta_cache");
+}
+
+static bool dna_member_is_pointer(const StringRef name)
+{
+  return name.startswith("*") || name.startswith("(*");
+}
+
+/**
+ * Append the byte ranges of the struct members starting at \a first_member, that are neither
+ * pointers nor runtime data. Nested structs are handled recursively.
+ */
+static void dna_struct_settings_ranges_append(const SDNA &sdna,
+                                              const SDNA_Struct &struct_info,
+                                              const int first_member,
+                                              int64_t offset,
+                                              Vector<IndexRange> &r_ranges)
+{
+  for (const int i : IndexRange(first_member, struct_info.members_num - first_member)) {
+    const SDNA_StructMember &member = struct_info.members[i];
+    const StringRef name = sdna.members[member.member_index];
+    const int64_t size = DNA_struct_member_size(&sdna, member.type_index, member.member_index);
+    if (dna_member_is_pointer(name) || dna_member_is_runtime(name)) {
+      offset += size;
+      continue;
+    }
+    const int member_struct_index = DNA_struct_find_index_without_alias(
+        &sdna, sdna.types[member.type_index]);
+    if (member_struct_index != -1) {
+      const SDNA_Struct &member_struct_info = *sdna.structs[member_struct_index];
+      const int64_t element_size = sdna.types_size[member.type_index];
+      for (const int element : IndexRange(sdna.members_array_num[member.member_index])) {
+        dna_struct_settings_ranges_append(
+            sdna, member_struct_info, 0, offset + element * element_size, r_ranges);
+      }
+    }
+    else if (!r_ranges.is_empty() && r_ranges.last().one_after_last() == offset) {
+      r_ranges.last() = IndexRange(r_ranges.last().start(), r_ranges.last().size() + size);
+    }
+    else {
+      r_ranges.append(IndexRange(offset, size));
+    }
+    offset += size;
+  }
+}
+
+/**
+ * Byte ranges of the modifier struct that contain its settings, for every modifier type. The
+ * common #ModifierData is skipped, it contains the error and timing of the last evaluation.
+ */
+static Span<std::optional<Vector<IndexRange>>> modifier_settings_ranges()
+{
+  static const Array<std::optional<Vector<IndexRange>>> ranges = []() {
+    Array<std::optional<Vector<IndexRange>>> ranges(NUM_MODIFIER_TYPES);
+    const SDNA *sdna = DNA_sdna_current_get();
+    if (sdna == nullptr) {
+      BLI_assert_unreachable();
+      return ranges;
+    }
+    for (const int type : ranges.index_range()) {
+      const ModifierTypeInfo *mti = BKE_modifier_get_info(ModifierType(type));
+      if (mti == nullptr) {
+        continue;
+      }
+      const int struct_index = DNA_struct_find_index_without_alias(sdna, mti->struct_name);
+      if (struct_index == -1) {
+        continue;
+      }
+      const SDNA_Struct &struct_info = *sdna->structs[struct_index];
+      if (struct_info.members_num == 0 ||
+          !STREQ(sdna->types[struct_info.members[0].type_index], "ModifierData") ||
+          dna_member_is_pointer(sdna->members[struct_info.members[0].member_index]))
+      {
+        continue;
+      }
+      BLI_assert(DNA_struct_size(sdna, struct_index) == mti->struct_size);
+      Vector<IndexRange> &type_ranges = ranges[type].emplace();
+      dna_struct_settings_ranges_append(
+          *sdna, struct_info, 1, int64_t(sizeof(ModifierData)), type_ranges);
+    }
+    return ranges;
+  }();
+  return ranges;
+}
+
+bool evaluated_mesh_key_add_modifier_settings(EvaluatedMeshKey &key, const ModifierData &md)
+{
+  const Span<std::optional<Vector<IndexRange>>> all_ranges = modifier_settings_ranges();
+  if (!all_ranges.index_range().contains(md.type) || !all_ranges[md.type]) {
+    return false;
+  }
+  key.add(md.type);
+  key.add(md.mode);
+  key.add(md.flag);
+  for (const IndexRange range : *all_ranges[md.type]) {
+    key.add_bytes(POINTER_OFFSET(&md, range.start()), range.size());
+  }
+  return true;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Cache Keys
+ * \{ */
+
+static void modifier_find_id_fn(void *user_data,
+                                Object * /*ob*/,
+                                ID **idpoin,
+                                LibraryForeachIDCallbackFlag /*cb_flag*/)
+{
+  if (*idpoin) {
+    *static_cast<bool *>(user_data) = true;
+  }
+}
+
+static bool modifier_result_is_cacheable(Object &ob, ModifierData &md)
+{
+  const ModifierTypeInfo *mti = BKE_modifier_get_info(ModifierType(md.type));
+  if (mti->flags & eModifierTypeFlag_UsesPointCache) {
+    return false;
+  }
+  switch (md.type) {
+    /* Node trees can access data that isn't referenced by the modifier itself. */
+    case eModifierType_Nodes:
+    /* Read external files. */
+    case eModifierType_MeshCache:
+    case eModifierType_Ocean:
+    /* Keep state between frames, or pass geometry to other objects. */
+    case eModifierType_Surface:
+    case eModifierType_Collision:
+    case eModifierType_Fluid:
+    case eModifierType_Fluidsim:
+    case eModifierType_Explode:
+    /* Writes the face count of its result to the original modifier. */
+    case eModifierType_Decimate:
+      return false;
+    case eModifierType_CorrectiveSmooth:
+      /* Binding writes the rest positions to the original modifier. */
+      if (reinterpret_cast<const CorrectiveSmoothModifierData &>(md).bind_coords_num == uint(-1))
+      {
+        return false;
+      }
+      break;
+    default:
+      break;
+  }
+  /* The evaluated copies of other data-blocks can change without changing this object. */
+  bool uses_id = false;
+  if (mti->foreach_ID_link) {
+    mti->foreach_ID_link(&md, &ob, modifier_find_id_fn, &uses_id);
+  }
+  return !uses_id;
+}
+
+/**
+ * Whether the modifier makes the depsgraph evaluate the geometry after the transform of the
+ * object, see #DEG_add_depends_on_transform_relation. Without that relation the transform can be
+ * written while the modifiers are evaluated. Modifiers that reference other objects are not
+ * cached at all, so only their conditions without references are handled here.
+ */
+static bool modifier_depends_on_transform(const ModifierData &md)
+{
+  switch (md.type) {
+    case eModifierType_Armature:
+    case eModifierType_Boolean:
+    case eModifierType_Curve:
+    case eModifierType_Hook:
+    case eModifierType_MeshDeform:
+    case eModifierType_MeshToVolume:
+    case eModifierType_Shrinkwrap:
+    case eModifierType_UVWarp:
+      return true;
+    case eModifierType_Displace: {
+      const DisplaceModifierData &dmd = reinterpret_cast<const DisplaceModifierData &>(md);
+      return dmd.space == MOD_DISP_SPACE_GLOBAL &&
+             ELEM(dmd.direction,
+                  MOD_DISP_DIR_X,
+                  MOD_DISP_DIR_Y,
+                  MOD_DISP_DIR_Z,
+                  MOD_DISP_DIR_RGB_XYZ);
+    }
+    default:
+      return false;
+  }
+}
+
+std::optional<EvaluatedMeshKey> evaluated_mesh_key_build(const Depsgraph &depsgraph,
+                                                         const Scene &scene,
+                                                         Object &ob,
+                                                         const CustomData_MeshMasks &mask,
+                                                         const bool need_mapping)
+{
+  if (!evaluated_mesh_cache_is_enabled()) {
+    return std::nullopt;
+  }
+  const Mesh &mesh = *id_cast<const Mesh *>(ob.data);
+  if (ob.mode != OB_MODE_OBJECT || ob.runtime->sculpt_session || mesh.runtime->edit_mesh ||
+      !BLI_listbase_is_empty(&ob.particlesystem))
+  {
+    return std::nullopt;
+  }
+  /* Animated mesh properties are changed in place, without a new copy of the mesh. */
+  if (BKE_animdata_id_is_animated(&mesh.id)) {
+    return std::nullopt;
+  }
+  const Key *key = mesh.key;
+  if (ob.id.runtime->eval_copy_version == 0 || mesh.id.runtime->eval_copy_version == 0 ||
+      (key && key->id.runtime->eval_copy_version == 0))
+  {
+    return std::nullopt;
+  }
+
+  const eEvaluationMode mode = DEG_get_mode(&depsgraph);
+  const int required_mode = (mode == DAG_EVAL_RENDER) ? eModifierMode_Render :
+                                                        eModifierMode_Realtime;
+
+  EvaluatedMeshKey cache_key;
+  cache_key.session_uid = DEG_get_original(&ob)->id.session_uid;
+  /* Data that is only changed by edits, like the data the modifiers point to, is covered by the
+   * versions, because those edits make the depsgraph copy the data-block again. */
+  cache_key.versions = {ob.id.runtime->eval_copy_version,
+                        mesh.id.runtime->eval_copy_version,
+                        key ? key->id.runtime->eval_copy_version : 0};
+  cache_key.add(mode);
+  cache_key.add(need_mapping);
+  cache_key.add(mask);
+  cache_key.add(ob.shapenr);
+  cache_key.add(ob.shapeflag);
+  cache_key.add(int(scene.r.mode & R_SIMPLIFY));
+  cache_key.add(scene.r.simplify_subsurf);
+  cache_key.add(scene.r.simplify_subsurf_render);
+
+  bool depends_on_time = false;
+  if (key) {
+    cache_key.add(key->type);
+    cache_key.add(key->ctime);
+    for (const KeyBlock &kb : key->block) {
+      cache_key.add(kb.pos);
+      cache_key.add(kb.curval);
+      cache_key.add(kb.type);
+      cache_key.add(kb.relative);
+      cache_key.add(kb.flag);
+      cache_key.add(kb.vgroup);
+    }
+    depends_on_time |= key->type != KEY_RELATIVE;
+  }
+
+  bool depends_on_transform = false;
+  bool has_enabled_modifier = false;
+  VirtualModifierData virtual_modifier_data;
+  for (ModifierData *md = BKE_modifiers_get_virtual_modifierlist(&ob, &virtual_modifier_data); md;
+       md = md->next)
+  {
+    if (!BKE_modifier_is_enabled(&scene, md, required_mode)) {
+      continue;
+    }
+    if (!modifier_result_is_cacheable(ob, *md)) {
+      return std::nullopt;
+    }
+    const ModifierTypeInfo *mti = BKE_modifier_get_info(ModifierType(md->type));
+    if (mti->depends_on_time && mti->depends_on_time(const_cast<Scene *>(&scene), md)) {
+      depends_on_time = true;
+    }
+    depends_on_transform |= modifier_depends_on_transform(*md);
+    if (!evaluated_mesh_key_add_modifier_settings(cache_key, *md)) {
+      return std::nullopt;
+    }
+    has_enabled_modifier = true;
+  }
+  if (!has_enabled_modifier) {
+    /* The original mesh is used directly, there is nothing to save. */
+    return std::nullopt;
+  }
+  if (depends_on_time) {
+    cache_key.add(DEG_get_ctime(&depsgraph));
+  }
+  /* The transform is only evaluated before the modifiers when they depend on it. */
+  if (depends_on_transform) {
+    cache_key.add(ob.object_to_world());
+  }
+  return cache_key;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Cache Values
+ * \{ */
+
+/**
+ * What is known about the cached results of one object in one depsgraph. The versions are unique
+ * for every evaluated copy, so depsgraphs never share results.
+ */
+struct EvaluatedMeshObjectState {
+  /** Versions of the most recent evaluation. Results of other versions have been removed. */
+  EvaluatedMeshVersions versions = {};
+  /** Duration of the most recent evaluation of the modifier stack, in seconds. */
+  double eval_time = 0.0;
+};
+
+struct EvaluatedMeshObjectStates {
+  Mutex mutex;
+  /** Keyed by the depsgraph and the #ID::session_uid of the original object. */
+  Map<std::pair<const Depsgraph *, uint32_t>, EvaluatedMeshObjectState> map;
+};
+
+static EvaluatedMeshObjectStates &get_object_states()
+{
+  static EvaluatedMeshObjectStates states;
+  return states;
+}
+
+bool evaluated_mesh_cache_prepare(const Depsgraph &depsgraph, const EvaluatedMeshKey &key)
+{
+  EvaluatedMeshObjectStates &states = get_object_states();
+  std::lock_guard lock{states.mutex};
+  bool is_new = false;
+  EvaluatedMeshObjectState &state = states.map.lookup_or_add_cb(
+      {&depsgraph, key.session_uid}, [&]() {
+        is_new = true;
+        return EvaluatedMeshObjectState();
+      });
+  if (state.versions != key.versions) {
+    if (!is_new) {
+      /* Only remove the results of the previous versions in this depsgraph, other depsgraphs
+       * evaluating the same object keep theirs. */
+      const EvaluatedMeshVersions old_versions = state.versions;
+      memory_cache::remove_if([&](const GenericKey &other) {
+        const auto *other_key = dynamic_cast<const EvaluatedMeshKey *>(&other);
+        return other_key && other_key->session_uid == key.session_uid &&
+               other_key->versions == old_versions;
+      });
+    }
+    state.versions = key.versions;
+  }
+  return state.eval_time >= min_eval_time_to_cache;
+}
+
+void evaluated_mesh_cache_eval_time_set(const Depsgraph &depsgraph,
+                                        const EvaluatedMeshKey &key,
+                                        const double seconds)
+{
+  EvaluatedMeshObjectStates &states = get_object_states();
+  std::lock_guard lock{states.mutex};
+  states.map.lookup_or_add_default({&depsgraph, key.session_uid}).eval_time = seconds;
+}
+
+std::unique_ptr<EvaluatedMeshValue> evaluated_mesh_value_create(const Object &ob,
+                                                                const Mesh &mesh_input,
+                                                                const Mesh &mesh_final,
+                                                                const Mesh *mesh_deform,
+                                                                const GeometrySet &geometry_set)
+{
+  auto value = std::make_unique<EvaluatedMeshValue>();
+  /* Meshes shared with other objects, or wrapping data that belongs to the modifiers (like GPU
+   * subdivision), are not stored. */
+  if (&mesh_final == mesh_input.runtime->mesh_eval ||
+      mesh_final.runtime->wrapper_type != ME_WRAPPER_TYPE_MDATA ||
+      mesh_final.runtime->subsurf_runtime_data != nullptr)
+  {
+    return value;
+  }
+  value->mesh_final = BKE_mesh_copy_for_eval(mesh_final);
+  if (mesh_deform) {
+    value->mesh_deform = BKE_mesh_copy_for_eval(*mesh_deform);
+  }
+  value->geometry_set = geometry_set;
+  for (const ModifierData &md : ob.modifiers) {
+    value->modifier_errors.append(md.error ? md.error : "");
+  }
+  return value;
+}
+
+void evaluated_mesh_value_restore_errors(const EvaluatedMeshValue &value, Object &ob)
+{
+  BKE_modifiers_clear_errors(&ob);
+  int index = 0;
+  for (ModifierData &md : ob.modifiers) {
+    if (index == value.modifier_errors.size()) {
+      break;
+    }
+    const std::string &error = value.modifier_errors[index++];
+    if (!error.empty()) {
+      md.error = BLI_strdupn(error.c_str(), error.size());
+    }
+  }
+}
+
+/** \} */
+
+}  // namespace blender::bke
@@ -0,0 +1,126 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ *
+ * The results of mesh modifier stacks are stored in the global #memory_cache, so that going back
+ * to a frame that was evaluated before, or to a frame where none of the inputs changed, doesn't
+ * evaluate the modifiers again. The inputs are the versions of the evaluated copies of the object,
+ * the mesh and its shape keys, together with all values that animation changes in place. Stacks
+ * that use other data-blocks, files or the results of previous frames are not cached.
+ */
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string>
+
+#include "BLI_memory_cache.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_geometry_set.hh"
+
+namespace blender {
+
+struct CustomData_MeshMasks;
+struct Depsgraph;
+struct Mesh;
+struct ModifierData;
+struct Object;
+struct Scene;
+
+namespace bke {
+
+/** The #ID_Runtime::eval_copy_version of the evaluated object, mesh and shape keys. */
+using EvaluatedMeshVersions = std::array<uint64_t, 3>;
+
+/**
+ * Identifies the result of the modifier stack of a mesh object. The fingerprint contains the
+ * inputs themselves instead of a hash of them, so that results are never mixed up.
+ */
+class EvaluatedMeshKey : public GenericKey {
+ public:
+  /** #ID::session_uid of the original object. */
+  uint32_t session_uid = 0;
+  EvaluatedMeshVersions versions = {};
+  /** Evaluation settings and all values that animation changes in place. */
+  Vector<uint8_t> fingerprint;
+
+  void add_bytes(const void *data, int64_t size);
+
+  template<typename T> void add(const T &value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    this->add_bytes(&value, sizeof(T));
+  }
+
+  uint64_t hash() const override;
+  bool equal_to(const GenericKey &other) const override;
+  std::unique_ptr<GenericKey> to_storable() const override;
+};
+
+/**
+ * Copies of the results of #mesh_calc_modifiers, sharing their arrays with the evaluated meshes
+ * they were created from. The meshes are null when the result could not be stored, in which case
+ * the modifiers are evaluated every time.
+ */
+class EvaluatedMeshValue : public memory_cache::CachedValue {
+ public:
+  Mesh *mesh_final = nullptr;
+  Mesh *mesh_deform = nullptr;
+  /** Non-mesh geometry created by the modifiers. */
+  GeometrySet geometry_set;
+  /** Errors and warnings of the object's modifiers, in the order of the modifier list. */
+  Vector<std::string> modifier_errors;
+
+  ~EvaluatedMeshValue() override;
+
+  void count_memory(MemoryCounter &memory) const override;
+};
+
+/** False when the cache is turned off in the debug preferences. */
+bool evaluated_mesh_cache_is_enabled();
+
+/**
+ * Add the settings of the modifier to the fingerprint. Those are the members of its DNA struct,
+ * without pointers and data that is only written by the evaluation.
+ *
+ * \return False if the settings of the modifier type are not known.
+ */
+bool evaluated_mesh_key_add_modifier_settings(EvaluatedMeshKey &key, const ModifierData &md);
+
+/** \return The key of the modifier stack result, or none if the result can't be cached. */
+std::optional<EvaluatedMeshKey> evaluated_mesh_key_build(const Depsgraph &depsgraph,
+                                                         const Scene &scene,
+                                                         Object &ob,
+                                                         const CustomData_MeshMasks &mask,
+                                                         bool need_mapping);
+
+/**
+ * Remove the cached results of the previous versions of the object in the depsgraph when the
+ * versions of the key are new. Those results can't be used anymore.
+ *
+ * \return Whether the last evaluation of the object in the depsgraph was slow enough to be worth
+ * storing and looking up the result in the cache.
+ */
+bool evaluated_mesh_cache_prepare(const Depsgraph &depsgraph, const EvaluatedMeshKey &key);
+
+/** Remember how long the modifier stack of the object took to evaluate in the depsgraph. */
+void evaluated_mesh_cache_eval_time_set(const Depsgraph &depsgraph,
+                                        const EvaluatedMeshKey &key,
+                                        double seconds);
+
+std::unique_ptr<EvaluatedMeshValue> evaluated_mesh_value_create(const Object &ob,
+                                                                const Mesh &mesh_input,
+                                                                const Mesh &mesh_final,
+                                                                const Mesh *mesh_deform,
+                                                                const GeometrySet &geometry_set);
+
+/** Report the errors of the modifiers again, when their evaluation is skipped. */
+void evaluated_mesh_value_restore_errors(const EvaluatedMeshValue &value, Object &ob);
+
+}  // namespace bke
+}  // namespace blender
@@ -0,0 +1,120 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_memory_cache.hh"
+
+#include "BKE_modifier.hh"
+
+#include "DNA_genfile.h"
+#include "DNA_modifier_types.h"
+
+#include "mesh_eval_cache.hh"
+
+namespace blender::bke::tests {
+
+class EvaluatedMeshCacheTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    DNA_sdna_current_init();
+    BKE_modifier_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    memory_cache::clear();
+    DNA_sdna_current_free();
+  }
+};
+
+TEST_F(EvaluatedMeshCacheTest, ModifierSettingsFingerprint)
+{
+  ModifierData *md = BKE_modifier_new(eModifierType_CorrectiveSmooth);
+  CorrectiveSmoothModifierData *csmd = reinterpret_cast<CorrectiveSmoothModifierData *>(md);
+  const auto fingerprint = [&]() {
+    EvaluatedMeshKey key;
+    EXPECT_TRUE(evaluated_mesh_key_add_modifier_settings(key, *md));
+    return key.fingerprint;
+  };
+  const Vector<uint8_t> initial = fingerprint();
+
+  /* Pointers, runtime caches and the results of the last evaluation are not settings. */
+  float bind_coords[1][3] = {{1.0f, 2.0f, 3.0f}};
+  csmd->bind_coords = bind_coords;
+  csmd->delta_cache.deltas_num = 10;
+  csmd->delta_cache.lambda = 2.0f;
+  md->execution_time = 1.0f;
+  EXPECT_TRUE(fingerprint().as_span() == initial.as_span());
+
+  csmd->lambda = 0.25f;
+  EXPECT_FALSE(fingerprint().as_span() == initial.as_span());
+
+  csmd->bind_coords = nullptr;
+  BKE_modifier_free(md);
+}
+
+TEST_F(EvaluatedMeshCacheTest, HitAndInvalidation)
+{
+  int compute_count = 0;
+  const auto lookup = [&](const EvaluatedMeshKey &key) {
+    memory_cache::get<EvaluatedMeshValue>(key, [&]() {
+      compute_count++;
+      return std::make_unique<EvaluatedMeshValue>();
+    });
+  };
+
+  /* The depsgraphs only identify the evaluations, they are never accessed. */
+  const int depsgraph_data[2] = {};
+  const Depsgraph &depsgraph = *reinterpret_cast<const Depsgraph *>(&depsgraph_data[0]);
+  const Depsgraph &other_depsgraph = *reinterpret_cast<const Depsgraph *>(&depsgraph_data[1]);
+
+  EvaluatedMeshKey key;
+  key.session_uid = 0xFFFF0001;
+  key.versions = {1, 2, 0};
+  key.add(10.0f);
+
+  /* Only results of slow evaluations are cached. */
+  EXPECT_FALSE(evaluated_mesh_cache_prepare(depsgraph, key));
+  evaluated_mesh_cache_eval_time_set(depsgraph, key, 1.0);
+  EXPECT_TRUE(evaluated_mesh_cache_prepare(depsgraph, key));
+
+  lookup(key);
+  EXPECT_EQ(compute_count, 1);
+  lookup(key);
+  EXPECT_EQ(compute_count, 1);
+
+  EvaluatedMeshKey other_object_key = key;
+  other_object_key.session_uid = 0xFFFF0002;
+  evaluated_mesh_cache_eval_time_set(depsgraph, other_object_key, 1.0);
+  EXPECT_TRUE(evaluated_mesh_cache_prepare(depsgraph, other_object_key));
+  lookup(other_object_key);
+  EXPECT_EQ(compute_count, 2);
+
+  /* Another depsgraph evaluating the same object has its own versions, and doesn't remove the
+   * results of the first depsgraph. */
+  EvaluatedMeshKey other_depsgraph_key = key;
+  other_depsgraph_key.versions = {4, 5, 0};
+  evaluated_mesh_cache_eval_time_set(other_depsgraph, other_depsgraph_key, 1.0);
+  EXPECT_TRUE(evaluated_mesh_cache_prepare(other_depsgraph, other_depsgraph_key));
+  lookup(other_depsgraph_key);
+  EXPECT_EQ(compute_count, 3);
+  lookup(key);
+  EXPECT_EQ(compute_count, 3);
+
+  /* A new version of the object removes the results of the previous version in the same
+   * depsgraph, but not the results of other objects or other depsgraphs. */
+  EvaluatedMeshKey new_version_key = key;
+  new_version_key.versions = {3, 2, 0};
+  EXPECT_TRUE(evaluated_mesh_cache_prepare(depsgraph, new_version_key));
+  lookup(key);
+  EXPECT_EQ(compute_count, 4);
+  lookup(other_object_key);
+  EXPECT_EQ(compute_count, 4);
+  lookup(other_depsgraph_key);
+  EXPECT_EQ(compute_count, 4);
+}
+
+}  // namespace blender::bke::tests
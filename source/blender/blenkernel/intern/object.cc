@@ -4891,6 +4891,7 @@ void BKE_object_runtime_reset_on_copy(Object *object, const int /*flag*/)
   bke::ObjectRuntime *runtime = object->runtime;
   runtime->data_eval = nullptr;
   runtime->mesh_deform_eval = nullptr;
+  runtime->bvh_refit.reset();
   runtime->curve_cache = nullptr;
   runtime->object_as_temp_mesh = nullptr;
   runtime->pose_backup = nullptr;
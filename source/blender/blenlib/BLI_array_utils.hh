@@ -326,6 +326,27 @@ template<typename T> inline void fill_index_range(MutableSpan<T> span, const T s
   std::iota(span.begin(), span.end(), start);
 }
 
+/**
+ * Zero-initialize a newly allocated buffer with #threading::parallel_for_numa, so that its pages
+ * are distributed over the NUMA nodes like the work of later #threading::parallel_for_numa loops.
+ * Small buffers are just cleared with `memset`.
+ */
+void fill_zero_numa(void *data, int64_t size_in_bytes);
+
+/**
+ * Construct all values in the uninitialized \a dst with copies of \a value, partitioned over
+ * NUMA nodes like #fill_zero_numa. Used for large #Array buffers that are processed with
+ * #threading::parallel_for_numa afterwards, e.g.:
+ *   `Array<float3> positions(size, NoInitialization());`
+ *   `array_utils::uninitialized_fill_numa(positions.as_mutable_span(), float3(0));`
+ */
+template<typename T> inline void uninitialized_fill_numa(MutableSpan<T> dst, const T &value)
+{
+  threading::parallel_for_numa(dst.index_range(), 4096, [&](const IndexRange range) {
+    uninitialized_fill_n(dst.slice(range).data(), range.size(), value);
+  });
+}
+
 template<typename T>
 bool indexed_data_equal(const Span<T> all_values, const Span<int> indices, const Span<T> values)
 {
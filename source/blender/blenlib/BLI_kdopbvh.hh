@@ -10,7 +10,9 @@
 
 #include "BLI_function_ref.hh"
 #include "BLI_hash.hh"
+#include "BLI_index_mask_fwd.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_struct_equality_utils.hh"
 #include "BLI_sys_types.h"
 
@@ -71,6 +73,19 @@ struct BVHTreeRay {
 #endif
 };
 
+/** Information about a tree build, see #BLI_bvhtree_balance_ex. */
+struct BVHTreeBuildStats {
+  /** Time spent building the tree, in seconds. */
+  double build_time;
+  /**
+   * Surface area heuristic cost of the tree, with unit traversal and intersection costs. Lower
+   * values mean faster queries, this can be used to compare build modes.
+   */
+  float sah_cost;
+  int branches_num;
+  int depth_max;
+};
+
 struct BVHTreeRayHit {
   /** Index of the tree node (untouched if no hit is found). */
   int index;
@@ -97,6 +112,18 @@ enum {
   /* calculate IsectRayPrecalc data */
   BVH_RAYCAST_WATERTIGHT = (1 << 0),
 };
+enum {
+  /**
+   * Build the tree with a binned surface area heuristic instead of median splits. Building is
+   * a bit more expensive, but the tree is usually faster to query, especially for elements with
+   * a non-uniform distribution. Only used for trees with X, Y and Z axes (not 18-DOP).
+   *
+   * Worth it for trees that are built once and then refit and queried many times, like the cloth
+   * and collision trees. Trees that are rebuilt on every change, like the mesh trees of
+   * `bvhutils.cc`, use median splits.
+   */
+  BVH_BALANCE_SAH = (1 << 0),
+};
 #define BVH_RAYCAST_DEFAULT (BVH_RAYCAST_WATERTIGHT)
 #define BVH_RAYCAST_DIST_MAX (FLT_MAX / 2.0f)
 
@@ -156,6 +183,11 @@ BVHTree *BLI_bvhtree_new(int maxsize, float epsilon, char tree_type, char axis);
  */
 void BLI_bvhtree_insert(BVHTree *tree, int index, const float co[3], int numpoints);
 void BLI_bvhtree_balance(BVHTree *tree);
+/**
+ * \param flag: #BVH_BALANCE_SAH.
+ * \param r_stats: Optionally filled with information about the built tree.
+ */
+void BLI_bvhtree_balance_ex(BVHTree *tree, int flag, BVHTreeBuildStats *r_stats);
 
 /**
  * Update: first update points/nodes, then call update_tree to refit the bounding volumes.
@@ -171,6 +203,34 @@ bool BLI_bvhtree_update_node(
  */
 void BLI_bvhtree_update_tree(BVHTree *tree);
 
+/**
+ * Duplicate a balanced tree, including its topology and bounding volumes. Copying is a lot
+ * cheaper than building a new tree, so a copy of a tree whose elements moved can be refitted
+ * with #BLI_bvhtree_refit instead.
+ */
+BVHTree *BLI_bvhtree_copy(const BVHTree *tree);
+
+/**
+ * Fill the points used to compute the bounds of the leaf with the given (inserted) index.
+ */
+using BVHTree_RefitCallback = FunctionRef<void(int index, MutableSpan<float3> r_points)>;
+
+/**
+ * Recompute the bounds of every leaf from the points given by \a fn, then refit the branches.
+ * Unlike #BLI_bvhtree_update_node and #BLI_bvhtree_update_tree, the work is done in parallel,
+ * so \a fn must be thread-safe. The topology of the tree is kept as is.
+ *
+ * \param points_num: The number of points making up every leaf (e.g. 3 for triangles).
+ */
+void BLI_bvhtree_refit(BVHTree &tree, int points_num, BVHTree_RefitCallback fn);
+
+/**
+ * Surface area heuristic cost of the tree, normalized by the area of the root bounds. Can be
+ * compared with #BVHTreeBuildStats.sah_cost after refitting to detect a degraded tree.
+ * Only meaningful for trees using the X, Y and Z axes (`axis` of 6, 8, 14 or 26).
+ */
+float BLI_bvhtree_sah_cost(const BVHTree &tree);
+
 /**
  * Use to check the total number of threads #BLI_bvhtree_overlap will use.
  *
@@ -342,6 +402,22 @@ inline void BLI_bvhtree_ray_cast_all_cpp(const BVHTree &tree,
       &fn);
 }
 
+/**
+ * Batched version of #BLI_bvhtree_ray_cast_ex, casting a ray for every index in \a mask.
+ *
+ * Every hit in \a r_hits must be initialized by the caller, like the `hit` argument of the single
+ * ray version (typically `index = -1` and `dist` set to the ray length). The rays are processed in
+ * parallel, so \a fn must be thread-safe. When \a fn is empty, the bounds of the leaves are used.
+ */
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                Span<float3> ray_origins,
+                                Span<float3> ray_directions,
+                                float radius,
+                                MutableSpan<BVHTreeRayHit> r_hits,
+                                BVHTree_RayCastCallback_CPP fn,
+                                int flag = BVH_RAYCAST_DEFAULT);
+
 using BVHTree_RangeQuery_CPP = FunctionRef<void(int index, const float3 &co, float dist_sq)>;
 
 inline void BLI_bvhtree_range_query_cpp(const BVHTree &tree,
@@ -12,9 +12,11 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_array.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_kdtree_types.hh"
 #include "BLI_math_base.h"
 #include "BLI_math_vector.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include <algorithm>
@@ -35,6 +37,9 @@ constexpr uint kd_node_unset = (uint(-1));
  */
 constexpr uint kd_node_root_is_init = (uint(-2));
 
+/** Sub-trees with fewer nodes are balanced on a single thread. */
+constexpr uint kd_balance_parallel_threshold = 8192;
+
 }  // namespace detail
 
 /**
@@ -145,13 +150,18 @@ static uint kdtree_balance(KDTreeNode<CoordT> *nodes, uint nodes_len, uint axis,
     }
   }
 
-  /* Set node and sort sub-nodes. */
+  /* Set node and sort sub-nodes. Both halves are independent, so they can be balanced in
+   * parallel. */
   node = &nodes[median];
   node->d = axis;
   axis = (axis + 1) % KDTree<CoordT>::DimsNum;
-  node->left = kdtree_balance(nodes, median, axis, ofs);
-  node->right = kdtree_balance(
-      nodes + median + 1, (nodes_len - (median + 1)), axis, (median + 1) + ofs);
+  threading::parallel_invoke(
+      nodes_len > detail::kd_balance_parallel_threshold,
+      [&]() { node->left = kdtree_balance(nodes, median, axis, ofs); },
+      [&]() {
+        node->right = kdtree_balance(
+            nodes + median + 1, (nodes_len - (median + 1)), axis, (median + 1) + ofs);
+      });
 
   return median + ofs;
 }
@@ -174,6 +184,29 @@ template<typename CoordT> inline void kdtree_balance(KDTree<CoordT> *tree)
 #endif
 }
 
+/**
+ * Create a balanced tree from the \a positions in \a mask, using their indices as node indices.
+ * This is faster than inserting every position and balancing afterwards, since the nodes are
+ * filled in parallel.
+ */
+template<typename CoordT>
+inline KDTree<CoordT> *kdtree_new_from_positions(const Span<CoordT> positions,
+                                                 const IndexMask &mask)
+{
+  KDTree<CoordT> *tree = kdtree_new<CoordT>(uint(mask.size()));
+  mask.foreach_index_optimized<int>(GrainSize(4096), [&](const int i, const int pos) {
+    KDTreeNode<CoordT> &node = tree->nodes[pos];
+    node.left = node.right = detail::kd_node_unset;
+    node.co = positions[i];
+    node.index = i;
+    node.d = 0;
+  });
+  tree->nodes_len = uint(mask.size());
+  tree->max_node_index = mask.is_empty() ? -1 : int(mask.last());
+  kdtree_balance(tree);
+  return tree;
+}
+
 namespace detail {
 
 template<typename CoordT>
@@ -1079,6 +1112,37 @@ inline int kdtree_calc_duplicates_cb(const KDTree<CoordT> *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Batched Queries
+ *
+ * Search for many positions at once, processing them in parallel.
+ * \{ */
+
+/**
+ * Find up to \a nearest_len_capacity nearest nodes for every position in \a mask, sorted by
+ * distance. The results are written to a buffer that is reused for all positions handled by the
+ * same task, and passed to `fn(int index, Span<KDTreeNearest<CoordT>> nearest)`, which must be
+ * thread-safe.
+ */
+template<typename CoordT, typename Fn>
+inline void kdtree_find_nearest_n_batch(const KDTree<CoordT> &tree,
+                                        const Span<CoordT> positions,
+                                        const IndexMask &mask,
+                                        const int nearest_len_capacity,
+                                        const Fn &fn)
+{
+  mask.foreach_segment(GrainSize(512), [&](const IndexMaskSegment segment) {
+    Array<KDTreeNearest<CoordT>, 16> nearest(nearest_len_capacity);
+    for (const int i : segment) {
+      const int nearest_len = kdtree_find_nearest_n<CoordT>(
+          &tree, positions[i], nearest.data(), uint(nearest_len_capacity));
+      fn(i, nearest.as_span().take_front(nearest_len));
+    }
+  });
+}
+
+/** \} */
+
 template<typename CoordT, typename Fn>
 inline int kdtree_find_nearest_cb_cpp(const KDTree<CoordT> *tree,
                                       const CoordT &co,
@@ -1195,6 +1259,11 @@ constexpr inline auto kdtree_2d_new = kdtree_new<float2>;
 constexpr inline auto kdtree_3d_new = kdtree_new<float3>;
 constexpr inline auto kdtree_4d_new = kdtree_new<float4>;
 
+constexpr inline auto kdtree_1d_new_from_positions = kdtree_new_from_positions<float1>;
+constexpr inline auto kdtree_2d_new_from_positions = kdtree_new_from_positions<float2>;
+constexpr inline auto kdtree_3d_new_from_positions = kdtree_new_from_positions<float3>;
+constexpr inline auto kdtree_4d_new_from_positions = kdtree_new_from_positions<float4>;
+
 constexpr inline auto kdtree_1d_free = kdtree_free<float1>;
 constexpr inline auto kdtree_2d_free = kdtree_free<float2>;
 constexpr inline auto kdtree_3d_free = kdtree_free<float3>;
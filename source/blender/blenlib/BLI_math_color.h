@@ -8,6 +8,8 @@
  * \ingroup bli
  */
 
+#include <cstddef>
+
 #include "BLI_math_inline.h"
 
 namespace blender {
@@ -89,6 +91,12 @@ float linearrgb_to_srgb(float c);
 
 void srgb_to_linearrgb_v3_v3(float linear[3], const float srgb[3]);
 void linearrgb_to_srgb_v3_v3(float srgb[3], const float linear[3]);
+/**
+ * Convert \a num RGBA pixels, alpha is copied unchanged. The buffers may be the same.
+ * Uses AVX2 or AVX-512 when the CPU supports it.
+ */
+void srgb_to_linearrgb_v4_array(float (*linear)[4], const float (*srgb)[4], size_t num);
+void linearrgb_to_srgb_v4_array(float (*srgb)[4], const float (*linear)[4], size_t num);
 
 MINLINE void srgb_to_linearrgb_v4(float linear[4], const float srgb[4]);
 MINLINE void linearrgb_to_srgb_v4(float srgb[4], const float linear[4]);
@@ -30,6 +30,12 @@ BLI_mmap_file *BLI_mmap_open(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
     ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
 
+/* Hints that the given range of the file is not going to be accessed again soon, so that the
+ * memory pages backing it can be released (reducing the resident memory of the process). The
+ * data stays valid, reading it again reloads it from the file.
+ * Only the pages entirely inside the range are affected. */
+void BLI_mmap_release_range(BLI_mmap_file *file, size_t offset, size_t length) ATTR_NONNULL(1);
+
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 size_t BLI_mmap_get_length(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 bool BLI_mmap_any_io_error(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
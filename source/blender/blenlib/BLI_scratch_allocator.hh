@@ -0,0 +1,88 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Scratch memory for short-lived containers in hot code paths.
+ *
+ * Every thread has an arena that hands out memory by bumping a pointer. This avoids contention in
+ * the system allocator when many threads allocate temporary buffers at the same time. Everything
+ * allocated from the arena while a #ScratchScope exists is reclaimed at once when the scope ends.
+ * When the outermost scope ends, the arena only keeps a small amount of memory for later scopes
+ * and frees the rest. The arenas don't use the guarded allocator, their size is given by
+ * #scratch_allocator_memory_in_use.
+ *
+ * Containers that use #ScratchAllocator must not outlive the innermost #ScratchScope of the
+ * thread they allocated on. Without any scope on the current thread, the guarded allocator is used
+ * instead, so code using these containers works the same when called from anywhere. Note that a
+ * thread waiting for other tasks may run them within its own scope, so containers should not be
+ * passed out of the task that created them.
+ *
+ * \code{.cc}
+ * ScratchScope scratch_scope;
+ * ScratchVector<int> indices;
+ * ScratchArray<float3> positions(size);
+ * \endcode
+ */
+
+#include "BLI_array.hh"
+#include "BLI_map.hh"
+#include "BLI_utility_mixins.hh"
+#include "BLI_vector.hh"
+
+namespace blender {
+
+/**
+ * Serve #ScratchAllocator allocations on the current thread from its arena while this object
+ * exists. Scopes can be nested, the memory allocated within a scope is reclaimed when it ends.
+ * Must be destructed on the thread that constructed it.
+ */
+class ScratchScope : NonCopyable, NonMovable {
+ private:
+  int64_t chunk_index_;
+  uintptr_t position_;
+
+ public:
+  ScratchScope();
+  ~ScratchScope();
+};
+
+/**
+ * Memory held by the arenas of all threads in bytes, including memory that is kept for later
+ * scopes.
+ */
+int64_t scratch_allocator_memory_in_use();
+
+/**
+ * Allocator for #Vector, #Array, #Map and other containers that uses the arena of the current
+ * thread when there is a #ScratchScope. Deallocation is usually free, unless the memory was
+ * allocated without a scope.
+ */
+class ScratchAllocator {
+ public:
+  void *allocate(size_t size, size_t alignment, const char *name);
+  void deallocate(void *ptr);
+};
+
+template<typename T, int64_t InlineBufferCapacity = default_inline_buffer_capacity(sizeof(T))>
+using ScratchVector = Vector<T, InlineBufferCapacity, ScratchAllocator>;
+
+template<typename T, int64_t InlineBufferCapacity = default_inline_buffer_capacity(sizeof(T))>
+using ScratchArray = Array<T, InlineBufferCapacity, ScratchAllocator>;
+
+template<typename Key,
+         typename Value,
+         int64_t InlineBufferCapacity = default_inline_buffer_capacity(sizeof(Key) +
+                                                                       sizeof(Value)),
+         typename ProbingStrategy = DefaultProbingStrategy,
+         typename Hash = DefaultHash<Key>,
+         typename IsEqual = DefaultEquality<Key>,
+         typename Slot = typename DefaultMapSlot<Key, Value>::type>
+using ScratchMap =
+    Map<Key, Value, InlineBufferCapacity, ProbingStrategy, Hash, IsEqual, Slot, ScratchAllocator>;
+
+}  // namespace blender
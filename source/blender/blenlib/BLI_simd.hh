@@ -43,3 +43,475 @@
 #else
 #  define BLI_HAVE_SSE4 0
 #endif
+
+/* AVX2 and AVX-512 are not part of the baseline, they are only enabled for source files that are
+ * compiled with additional flags. Code using them has to be selected at run-time, see
+ * #BLI_SIMD_DISPATCH. MSVC doesn't define `__FMA__`, but `/arch:AVX2` implies FMA. */
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#  include <immintrin.h>
+#  define BLI_HAVE_AVX2 1
+#else
+#  define BLI_HAVE_AVX2 0
+#endif
+
+#if BLI_HAVE_AVX2 && defined(__AVX512F__) && defined(__AVX512VL__)
+#  define BLI_HAVE_AVX512 1
+#else
+#  define BLI_HAVE_AVX512 0
+#endif
+
+/* The vector types below are defined differently depending on the instruction set. To avoid
+ * violating the one definition rule, the kernel files that are compiled with extra flags define
+ * the namespace of their instruction set before including this file. All other files use the
+ * baseline namespace, also when the whole build uses flags like `-march=native`, so that the
+ * baseline kernels are always defined. */
+#ifndef BLI_SIMD_ARCH_NAMESPACE
+#  define BLI_SIMD_ARCH_NAMESPACE baseline
+#endif
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "BLI_math_inline.h"
+
+namespace blender::simd {
+
+/* -------------------------------------------------------------------- */
+/** \name Run-time Dispatch
+ *
+ * Kernels that benefit from wider vectors are compiled once per instruction set: the regular
+ * source file for the baseline, and copies of it compiled with AVX2 or AVX-512 flags (see
+ * `WITH_BLI_SIMD_AVX2` in the blenlib `CMakeLists.txt`). Each copy defines the kernel in its own
+ * #BLI_SIMD_ARCH_NAMESPACE, the caller picks the best one that is supported by the CPU.
+ * \{ */
+
+enum class CPUArch {
+  Baseline,
+  AVX2,
+  AVX512,
+};
+
+/** The most capable instruction set that is supported by the CPU and was compiled in. */
+CPUArch cpu_arch();
+
+namespace detail {
+/** Only deduce the function type from the baseline function, so that the others can be null. */
+template<typename T> struct NonDeduced {
+  using type = T;
+};
+}  // namespace detail
+
+template<typename Fn>
+inline Fn dispatch(typename detail::NonDeduced<Fn>::type avx512_fn,
+                   typename detail::NonDeduced<Fn>::type avx2_fn,
+                   Fn baseline_fn)
+{
+  switch (cpu_arch()) {
+    case CPUArch::AVX512:
+      if (avx512_fn) {
+        return avx512_fn;
+      }
+      [[fallthrough]];
+    case CPUArch::AVX2:
+      if (avx2_fn) {
+        return avx2_fn;
+      }
+      [[fallthrough]];
+    case CPUArch::Baseline:
+      break;
+  }
+  return baseline_fn;
+}
+
+}  // namespace blender::simd
+
+#ifdef WITH_BLI_SIMD_AVX2
+#  define BLI_SIMD_AVX2_KERNEL(name) &blender::simd::avx2::name
+#else
+#  define BLI_SIMD_AVX2_KERNEL(name) nullptr
+#endif
+#ifdef WITH_BLI_SIMD_AVX512
+#  define BLI_SIMD_AVX512_KERNEL(name) &blender::simd::avx512::name
+#else
+#  define BLI_SIMD_AVX512_KERNEL(name) nullptr
+#endif
+
+/**
+ * Declare a function in the namespaces of all instruction sets, has to be used in the global
+ * namespace. The definitions are expected to come from a source file that is compiled once per
+ * instruction set.
+ */
+#define BLI_SIMD_DECLARE_KERNEL(return_type, name, params) \
+  namespace blender::simd { \
+  namespace baseline { \
+  return_type name params; \
+  } \
+  namespace avx2 { \
+  return_type name params; \
+  } \
+  namespace avx512 { \
+  return_type name params; \
+  } \
+  }
+
+/** The best variant of a kernel declared with #BLI_SIMD_DECLARE_KERNEL. */
+#define BLI_SIMD_DISPATCH(name) \
+  blender::simd::dispatch( \
+      BLI_SIMD_AVX512_KERNEL(name), BLI_SIMD_AVX2_KERNEL(name), &blender::simd::baseline::name)
+
+/** \} */
+
+namespace blender::simd {
+inline namespace BLI_SIMD_ARCH_NAMESPACE {
+
+/* -------------------------------------------------------------------- */
+/** \name Vector Types
+ *
+ * Thin wrappers around SIMD registers with a scalar fallback, so that kernels can be written
+ * once for all instruction sets. Comparisons return masks with all bits set in the lanes where
+ * the comparison is true, to be used with #select.
+ * \{ */
+
+MALWAYS_INLINE float bits_as_float(const int32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+MALWAYS_INLINE int32_t float_as_bits(const float value)
+{
+  int32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+struct vfloat4 {
+  static constexpr int size = 4;
+#if BLI_HAVE_SSE2
+  __m128 m;
+
+  vfloat4() = default;
+  MALWAYS_INLINE vfloat4(const __m128 m) : m(m) {}
+  MALWAYS_INLINE explicit vfloat4(const float value) : m(_mm_set1_ps(value)) {}
+  MALWAYS_INLINE vfloat4(const float a, const float b, const float c, const float d)
+      : m(_mm_setr_ps(a, b, c, d))
+  {
+  }
+
+  MALWAYS_INLINE static vfloat4 load(const float *ptr)
+  {
+    return _mm_loadu_ps(ptr);
+  }
+  MALWAYS_INLINE void store(float *ptr) const
+  {
+    _mm_storeu_ps(ptr, m);
+  }
+  MALWAYS_INLINE static vfloat4 from_bits(const int32_t bits)
+  {
+    return _mm_castsi128_ps(_mm_set1_epi32(bits));
+  }
+#else
+  float v[4];
+
+  vfloat4() = default;
+  MALWAYS_INLINE explicit vfloat4(const float value) : v{value, value, value, value} {}
+  MALWAYS_INLINE vfloat4(const float a, const float b, const float c, const float d)
+      : v{a, b, c, d}
+  {
+  }
+
+  MALWAYS_INLINE static vfloat4 load(const float *ptr)
+  {
+    return {ptr[0], ptr[1], ptr[2], ptr[3]};
+  }
+  MALWAYS_INLINE void store(float *ptr) const
+  {
+    memcpy(ptr, v, sizeof(v));
+  }
+  MALWAYS_INLINE static vfloat4 from_bits(const int32_t bits)
+  {
+    return vfloat4(bits_as_float(bits));
+  }
+#endif
+};
+
+#if BLI_HAVE_SSE2
+
+MALWAYS_INLINE vfloat4 operator+(const vfloat4 a, const vfloat4 b)
+{
+  return _mm_add_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat4 operator-(const vfloat4 a, const vfloat4 b)
+{
+  return _mm_sub_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat4 operator*(const vfloat4 a, const vfloat4 b)
+{
+  return _mm_mul_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat4 operator/(const vfloat4 a, const vfloat4 b)
+{
+  return _mm_div_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat4 operator<(const vfloat4 a, const vfloat4 b)
+{
+  return _mm_cmplt_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat4 min(const vfloat4 a, const vfloat4 b)
+{
+  return _mm_min_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat4 max(const vfloat4 a, const vfloat4 b)
+{
+  return _mm_max_ps(a.m, b.m);
+}
+/** Per lane `mask ? a : b`. */
+MALWAYS_INLINE vfloat4 select(const vfloat4 mask, const vfloat4 a, const vfloat4 b)
+{
+#  if BLI_HAVE_SSE4
+  return _mm_blendv_ps(b.m, a.m, mask.m);
+#  else
+  return _mm_or_ps(_mm_and_ps(mask.m, a.m), _mm_andnot_ps(mask.m, b.m));
+#  endif
+}
+/** Approximate `1 / sqrt(a)`, with a relative error of about `1e-7`. */
+MALWAYS_INLINE vfloat4 rsqrt(const vfloat4 a)
+{
+  __m128 r = _mm_rsqrt_ps(a.m);
+  /* Only do additional Newton-Raphson iterations when using actual SSE
+   * code path. When we are emulating SSE on NEON via sse2neon, the
+   * additional NR iterations are already done inside _mm_rsqrt_ps
+   * emulation. */
+#  if defined(__SSE2__)
+  r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.5f), r),
+                 _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(a.m, _mm_set1_ps(-0.5f)), r), _mm_mul_ps(r, r)));
+#  endif
+  return r;
+}
+/** Interpret the bits of every lane as integer and convert that to float. */
+MALWAYS_INLINE vfloat4 float_from_int_bits(const vfloat4 a)
+{
+  return _mm_cvtepi32_ps(_mm_castps_si128(a.m));
+}
+/** Round every lane to the nearest integer and store its bits. Inverse of #float_from_int_bits. */
+MALWAYS_INLINE vfloat4 int_bits_from_float(const vfloat4 a)
+{
+  return _mm_castsi128_ps(_mm_cvtps_epi32(a.m));
+}
+
+#else
+
+template<typename Fn>
+MALWAYS_INLINE vfloat4 vfloat4_map(const vfloat4 a, const vfloat4 b, const Fn &fn)
+{
+  return {fn(a.v[0], b.v[0]), fn(a.v[1], b.v[1]), fn(a.v[2], b.v[2]), fn(a.v[3], b.v[3])};
+}
+
+MALWAYS_INLINE vfloat4 operator+(const vfloat4 a, const vfloat4 b)
+{
+  return vfloat4_map(a, b, [](const float x, const float y) { return x + y; });
+}
+MALWAYS_INLINE vfloat4 operator-(const vfloat4 a, const vfloat4 b)
+{
+  return vfloat4_map(a, b, [](const float x, const float y) { return x - y; });
+}
+MALWAYS_INLINE vfloat4 operator*(const vfloat4 a, const vfloat4 b)
+{
+  return vfloat4_map(a, b, [](const float x, const float y) { return x * y; });
+}
+MALWAYS_INLINE vfloat4 operator/(const vfloat4 a, const vfloat4 b)
+{
+  return vfloat4_map(a, b, [](const float x, const float y) { return x / y; });
+}
+MALWAYS_INLINE vfloat4 operator<(const vfloat4 a, const vfloat4 b)
+{
+  return vfloat4_map(
+      a, b, [](const float x, const float y) { return bits_as_float(-int32_t(x < y)); });
+}
+MALWAYS_INLINE vfloat4 min(const vfloat4 a, const vfloat4 b)
+{
+  return vfloat4_map(a, b, [](const float x, const float y) { return x < y ? x : y; });
+}
+MALWAYS_INLINE vfloat4 max(const vfloat4 a, const vfloat4 b)
+{
+  return vfloat4_map(a, b, [](const float x, const float y) { return x > y ? x : y; });
+}
+MALWAYS_INLINE vfloat4 select(const vfloat4 mask, const vfloat4 a, const vfloat4 b)
+{
+  vfloat4 result;
+  for (int i = 0; i < 4; i++) {
+    result.v[i] = float_as_bits(mask.v[i]) ? a.v[i] : b.v[i];
+  }
+  return result;
+}
+MALWAYS_INLINE vfloat4 rsqrt(const vfloat4 a)
+{
+  return vfloat4_map(a, a, [](const float x, const float /*y*/) { return 1.0f / sqrtf(x); });
+}
+MALWAYS_INLINE vfloat4 float_from_int_bits(const vfloat4 a)
+{
+  return vfloat4_map(
+      a, a, [](const float x, const float /*y*/) { return float(float_as_bits(x)); });
+}
+MALWAYS_INLINE vfloat4 int_bits_from_float(const vfloat4 a)
+{
+  return vfloat4_map(
+      a, a, [](const float x, const float /*y*/) { return bits_as_float(int32_t(rintf(x))); });
+}
+
+#endif
+
+/** Eight floats, a single register with AVX2 and two #vfloat4 otherwise. */
+struct vfloat8 {
+  static constexpr int size = 8;
+#if BLI_HAVE_AVX2
+  __m256 m;
+
+  vfloat8() = default;
+  MALWAYS_INLINE vfloat8(const __m256 m) : m(m) {}
+  MALWAYS_INLINE explicit vfloat8(const float value) : m(_mm256_set1_ps(value)) {}
+
+  MALWAYS_INLINE static vfloat8 load(const float *ptr)
+  {
+    return _mm256_loadu_ps(ptr);
+  }
+  MALWAYS_INLINE void store(float *ptr) const
+  {
+    _mm256_storeu_ps(ptr, m);
+  }
+  MALWAYS_INLINE static vfloat8 from_bits(const int32_t bits)
+  {
+    return _mm256_castsi256_ps(_mm256_set1_epi32(bits));
+  }
+#else
+  vfloat4 lo;
+  vfloat4 hi;
+
+  vfloat8() = default;
+  MALWAYS_INLINE vfloat8(const vfloat4 lo, const vfloat4 hi) : lo(lo), hi(hi) {}
+  MALWAYS_INLINE explicit vfloat8(const float value) : lo(value), hi(value) {}
+
+  MALWAYS_INLINE static vfloat8 load(const float *ptr)
+  {
+    return {vfloat4::load(ptr), vfloat4::load(ptr + 4)};
+  }
+  MALWAYS_INLINE void store(float *ptr) const
+  {
+    lo.store(ptr);
+    hi.store(ptr + 4);
+  }
+  MALWAYS_INLINE static vfloat8 from_bits(const int32_t bits)
+  {
+    return {vfloat4::from_bits(bits), vfloat4::from_bits(bits)};
+  }
+#endif
+};
+
+#if BLI_HAVE_AVX2
+
+MALWAYS_INLINE vfloat8 operator+(const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_add_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat8 operator-(const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_sub_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat8 operator*(const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_mul_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat8 operator/(const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_div_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat8 operator<(const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_cmp_ps(a.m, b.m, _CMP_LT_OQ);
+}
+MALWAYS_INLINE vfloat8 min(const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_min_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat8 max(const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_max_ps(a.m, b.m);
+}
+MALWAYS_INLINE vfloat8 select(const vfloat8 mask, const vfloat8 a, const vfloat8 b)
+{
+  return _mm256_blendv_ps(b.m, a.m, mask.m);
+}
+MALWAYS_INLINE vfloat8 rsqrt(const vfloat8 a)
+{
+  const __m256 r = _mm256_rsqrt_ps(a.m);
+  /* One Newton-Raphson iteration, same as for #vfloat4. */
+  return _mm256_fmadd_ps(
+      _mm256_set1_ps(1.5f),
+      r,
+      _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(a.m, _mm256_set1_ps(-0.5f)), r),
+                    _mm256_mul_ps(r, r)));
+}
+MALWAYS_INLINE vfloat8 float_from_int_bits(const vfloat8 a)
+{
+  return _mm256_cvtepi32_ps(_mm256_castps_si256(a.m));
+}
+MALWAYS_INLINE vfloat8 int_bits_from_float(const vfloat8 a)
+{
+  return _mm256_castsi256_ps(_mm256_cvtps_epi32(a.m));
+}
+
+#else
+
+MALWAYS_INLINE vfloat8 operator+(const vfloat8 a, const vfloat8 b)
+{
+  return {a.lo + b.lo, a.hi + b.hi};
+}
+MALWAYS_INLINE vfloat8 operator-(const vfloat8 a, const vfloat8 b)
+{
+  return {a.lo - b.lo, a.hi - b.hi};
+}
+MALWAYS_INLINE vfloat8 operator*(const vfloat8 a, const vfloat8 b)
+{
+  return {a.lo * b.lo, a.hi * b.hi};
+}
+MALWAYS_INLINE vfloat8 operator/(const vfloat8 a, const vfloat8 b)
+{
+  return {a.lo / b.lo, a.hi / b.hi};
+}
+MALWAYS_INLINE vfloat8 operator<(const vfloat8 a, const vfloat8 b)
+{
+  return {a.lo < b.lo, a.hi < b.hi};
+}
+MALWAYS_INLINE vfloat8 min(const vfloat8 a, const vfloat8 b)
+{
+  return {min(a.lo, b.lo), min(a.hi, b.hi)};
+}
+MALWAYS_INLINE vfloat8 max(const vfloat8 a, const vfloat8 b)
+{
+  return {max(a.lo, b.lo), max(a.hi, b.hi)};
+}
+MALWAYS_INLINE vfloat8 select(const vfloat8 mask, const vfloat8 a, const vfloat8 b)
+{
+  return {select(mask.lo, a.lo, b.lo), select(mask.hi, a.hi, b.hi)};
+}
+MALWAYS_INLINE vfloat8 rsqrt(const vfloat8 a)
+{
+  return {rsqrt(a.lo), rsqrt(a.hi)};
+}
+MALWAYS_INLINE vfloat8 float_from_int_bits(const vfloat8 a)
+{
+  return {float_from_int_bits(a.lo), float_from_int_bits(a.hi)};
+}
+MALWAYS_INLINE vfloat8 int_bits_from_float(const vfloat8 a)
+{
+  return {int_bits_from_float(a.lo), int_bits_from_float(a.hi)};
+}
+
+#endif
+
+/** \} */
+
+}  // namespace BLI_SIMD_ARCH_NAMESPACE
+}  // namespace blender::simd
@@ -8,12 +8,21 @@
  * \ingroup bli
  */
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
 #ifdef WITH_TBB
 #  include <tbb/parallel_sort.h>
-#else
-#  include <algorithm>
 #endif
 
+#include "BLI_array.hh"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+
 namespace blender {
 
 #ifdef WITH_TBB
@@ -31,4 +40,206 @@ void parallel_sort(RandomAccessIterator begin, RandomAccessIterator end, const C
 }
 #endif
 
+namespace radix_sort_detail {
+
+template<typename T>
+inline constexpr bool is_sortable_key_v = (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+                                          std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template<typename T>
+using KeyBits = std::conditional_t<
+    sizeof(T) == 1,
+    uint8_t,
+    std::conditional_t<sizeof(T) == 2,
+                       uint16_t,
+                       std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+/**
+ * Map a key to an unsigned integer, so that comparing the integers gives the same order as
+ * comparing the keys. Negative and positive zero map to the same value, because they compare
+ * equal. NaN values end up at the start or end, depending on their sign bit.
+ */
+template<typename T> inline KeyBits<T> to_ordered_bits(const T key)
+{
+  using Bits = KeyBits<T>;
+  constexpr Bits sign_bit = Bits(1) << (sizeof(T) * 8 - 1);
+  if constexpr (std::is_floating_point_v<T>) {
+    const T normalized_key = key == T(0) ? T(0) : key;
+    Bits bits;
+    memcpy(&bits, &normalized_key, sizeof(T));
+    return (bits & sign_bit) ? Bits(~bits) : Bits(bits | sign_bit);
+  }
+  else if constexpr (std::is_signed_v<T>) {
+    return Bits(Bits(key) ^ sign_bit);
+  }
+  else {
+    return Bits(key);
+  }
+}
+
+template<typename T> inline bool ordered_less(const T a, const T b)
+{
+  return to_ordered_bits(a) < to_ordered_bits(b);
+}
+
+/** Below this size a comparison sort is faster than the radix passes and their setup. */
+constexpr int64_t min_radix_sort_size = 2048;
+/** Every block is counted and scattered by a single task. */
+constexpr int64_t min_block_size = 16 * 1024;
+constexpr int64_t max_blocks_num = 256;
+
+constexpr int digit_bits = 8;
+constexpr int digits_num = 1 << digit_bits;
+
+/**
+ * Stable LSD radix sort processing eight bits per pass. Every pass counts the digits in each block
+ * in parallel and then scatters the blocks in parallel, each to the ranges reserved for it. Passes
+ * where all keys have the same digit (e.g. the upper bytes of small integers) are skipped.
+ */
+template<typename Key, typename Value>
+void radix_sort(MutableSpan<Key> keys, MutableSpan<Value> values)
+{
+  constexpr bool with_values = !std::is_same_v<Value, std::monostate>;
+  const int64_t size = keys.size();
+  const int64_t blocks_num = std::clamp<int64_t>(size / min_block_size, 1, max_blocks_num);
+  const int64_t block_size = (size + blocks_num - 1) / blocks_num;
+  const auto block_range = [&](const int64_t block) {
+    return IndexRange(block * block_size, std::min(block_size, size - block * block_size));
+  };
+
+  Array<Key, 0> keys_buffer(size, NoInitialization());
+  Array<Value, 0> values_buffer(with_values ? size : 0, NoInitialization());
+  MutableSpan<Key> src_keys = keys;
+  MutableSpan<Key> dst_keys = keys_buffer;
+  MutableSpan<Value> src_values = values;
+  MutableSpan<Value> dst_values = values_buffer;
+
+  Array<std::array<int64_t, digits_num>, 0> block_offsets(blocks_num);
+  for (int shift = 0; shift < int(sizeof(Key)) * 8; shift += digit_bits) {
+    const auto digit = [&](const Key key) {
+      return int(to_ordered_bits(key) >> shift) & (digits_num - 1);
+    };
+
+    threading::parallel_for(IndexRange(blocks_num), 1, [&](const IndexRange range) {
+      for (const int64_t block : range) {
+        std::array<int64_t, digits_num> &counts = block_offsets[block];
+        counts.fill(0);
+        for (const int64_t i : block_range(block)) {
+          counts[digit(src_keys[i])]++;
+        }
+      }
+    });
+
+    /* Turn the counts into the start of every digit of every block in the destination. */
+    int64_t offset = 0;
+    bool all_keys_have_same_digit = false;
+    for (const int d : IndexRange(digits_num)) {
+      const int64_t digit_start = offset;
+      for (std::array<int64_t, digits_num> &counts : block_offsets) {
+        const int64_t count = counts[d];
+        counts[d] = offset;
+        offset += count;
+      }
+      if (offset - digit_start == size) {
+        all_keys_have_same_digit = true;
+        break;
+      }
+    }
+    if (all_keys_have_same_digit) {
+      continue;
+    }
+
+    threading::parallel_for(IndexRange(blocks_num), 1, [&](const IndexRange range) {
+      for (const int64_t block : range) {
+        std::array<int64_t, digits_num> &offsets = block_offsets[block];
+        for (const int64_t i : block_range(block)) {
+          const int64_t dst_index = offsets[digit(src_keys[i])]++;
+          dst_keys[dst_index] = src_keys[i];
+          if constexpr (with_values) {
+            dst_values[dst_index] = src_values[i];
+          }
+        }
+      }
+    });
+    std::swap(src_keys, dst_keys);
+    std::swap(src_values, dst_values);
+  }
+
+  if (src_keys.data() != keys.data()) {
+    threading::parallel_for(keys.index_range(), 16 * 1024, [&](const IndexRange range) {
+      keys.slice(range).copy_from(src_keys.slice(range));
+      if constexpr (with_values) {
+        values.slice(range).copy_from(src_values.slice(range));
+      }
+    });
+  }
+}
+
+}  // namespace radix_sort_detail
+
+/**
+ * Sort integer or floating point keys in ascending order, using a parallel radix sort for large
+ * spans and a comparison sort otherwise. Floating point values are ordered like with `<`, NaN
+ * values end up at the start or end.
+ */
+template<typename Key> void parallel_radix_sort(MutableSpan<Key> keys)
+{
+  static_assert(radix_sort_detail::is_sortable_key_v<Key>);
+  if (keys.size() < radix_sort_detail::min_radix_sort_size) {
+    std::sort(keys.begin(), keys.end(), radix_sort_detail::ordered_less<Key>);
+    return;
+  }
+  radix_sort_detail::radix_sort(keys, MutableSpan<std::monostate>());
+}
+
+/**
+ * Sort \a values by the integer or floating point \a keys with the same index. Both spans are
+ * reordered. The sort is stable, so values with equal keys keep their relative order.
+ */
+template<typename Key, typename Value>
+void parallel_radix_sort_by_key(MutableSpan<Key> keys, MutableSpan<Value> values)
+{
+  static_assert(radix_sort_detail::is_sortable_key_v<Key>);
+  static_assert(std::is_trivially_copyable_v<Value>);
+  BLI_assert(keys.size() == values.size());
+  if (keys.size() < radix_sort_detail::min_radix_sort_size) {
+    Array<std::pair<Key, Value>> pairs(keys.size());
+    for (const int64_t i : keys.index_range()) {
+      pairs[i] = {keys[i], values[i]};
+    }
+    std::stable_sort(pairs.begin(), pairs.end(), [](const auto &a, const auto &b) {
+      return radix_sort_detail::ordered_less(a.first, b.first);
+    });
+    for (const int64_t i : keys.index_range()) {
+      keys[i] = pairs[i].first;
+      values[i] = pairs[i].second;
+    }
+    return;
+  }
+  radix_sort_detail::radix_sort(keys, values);
+}
+
+/**
+ * Stable sort of \a indices by `keys[index]`. This is the same as sorting with a comparator that
+ * looks up the keys, but much faster for large spans.
+ */
+template<typename Key, typename IndexT>
+void parallel_sort_indices_by_key(const Span<Key> keys, MutableSpan<IndexT> indices)
+{
+  static_assert(radix_sort_detail::is_sortable_key_v<Key>);
+  if (indices.size() < radix_sort_detail::min_radix_sort_size) {
+    std::stable_sort(indices.begin(), indices.end(), [&](const IndexT a, const IndexT b) {
+      return radix_sort_detail::ordered_less(keys[a], keys[b]);
+    });
+    return;
+  }
+  Array<Key> sorted_keys(indices.size(), NoInitialization());
+  threading::parallel_for(indices.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      sorted_keys[i] = keys[indices[i]];
+    }
+  });
+  radix_sort_detail::radix_sort(sorted_keys.as_mutable_span(), indices);
+}
+
 }  // namespace blender
@@ -14,6 +14,13 @@ namespace blender {
 
 int BLI_cpu_support_sse2(void);
 int BLI_cpu_support_sse42(void);
+/**
+ * AVX2 and FMA, including support by the operating system. With MSVC, also the other `x86-64-v3`
+ * extensions (BMI1, BMI2, LZCNT, MOVBE and F16C) that `/arch:AVX2` may generate code for.
+ */
+int BLI_cpu_support_avx2(void);
+/** AVX-512 F, BW, CD, DQ and VL (as in `x86-64-v4`), including operating system support. */
+int BLI_cpu_support_avx512(void);
 /**
  * Write a backtrace into a file for systems which support it.
  */
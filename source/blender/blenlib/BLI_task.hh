@@ -68,6 +68,9 @@ void parallel_for_impl(IndexRange range,
                        FunctionRef<void(IndexRange)> function,
                        const TaskSizeHints &size_hints);
 void memory_bandwidth_bound_task_impl(FunctionRef<void()> function);
+void parallel_for_numa_impl(IndexRange range,
+                            int64_t grain_size,
+                            FunctionRef<void(IndexRange)> function);
 }  // namespace detail
 
 /**
@@ -275,5 +278,37 @@ inline void memory_bandwidth_bound_task(const int64_t approximate_bytes_touched,
   detail::memory_bandwidth_bound_task_impl(function);
 }
 
+/**
+ * The number of NUMA nodes the task scheduler distributes work over with #parallel_for_numa.
+ * This is 1 on most systems, and also when TBB was built without NUMA support.
+ */
+int numa_nodes_num();
+
+/**
+ * Same as #parallel_for, but the range is split into one contiguous part per NUMA node, and each
+ * part is only processed by threads pinned to that node. The split only depends on the size of
+ * the range and the number of nodes.
+ *
+ * Memory pages are usually placed on the node of the thread that touches them first. So when a
+ * large buffer is initialized with this function (see e.g. #array_utils::fill_zero_numa), later
+ * loops over the same range that also use it mostly access node-local memory. This matters for
+ * memory bandwidth bound loops on multi-socket systems, where accessing memory of another node
+ * is considerably slower.
+ */
+template<typename Function>
+inline void parallel_for_numa(const IndexRange range,
+                              const int64_t grain_size,
+                              const Function &function)
+{
+  if (range.is_empty()) {
+    return;
+  }
+  if (range.size() <= grain_size) {
+    function(range);
+    return;
+  }
+  detail::parallel_for_numa_impl(range, grain_size, function);
+}
+
 }  // namespace threading
 }  // namespace blender
@@ -0,0 +1,86 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Opt-in recording of the tasks executed by #threading::parallel_for, task pools and task graphs,
+ * written as Chrome trace JSON. The file can be opened in `chrome://tracing` or
+ * https://ui.perfetto.dev to see where threads are idle.
+ *
+ * Recording is disabled by default. Then the only overhead is checking #is_enabled() once per
+ * task.
+ */
+
+#include <atomic>
+#include <chrono>
+
+#include "BLI_string_ref.hh"
+
+namespace blender::threading::profiler {
+
+namespace detail {
+extern std::atomic<bool> is_enabled;
+}
+
+/** Start recording tasks. The trace is written to \a filepath by #finish. */
+void start(StringRefNull filepath);
+
+/**
+ * Stop recording and write the recorded tasks to the file passed to #start.
+ * Does nothing when recording wasn't started.
+ */
+void finish();
+
+inline bool is_enabled()
+{
+  return detail::is_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * The label of the innermost #ScopedLabel on the current thread. Tasks inherit the label of the
+ * thread that created them, so that their work can be attributed to e.g. a #timeit::ScopedTimer.
+ */
+int current_label();
+
+/**
+ * Record the execution of a task on the current thread, for the lifetime of this object.
+ */
+class ScopedTask {
+  const char *name_;
+  int label_;
+  int previous_label_;
+  int64_t grain_size_;
+  int64_t size_;
+  std::chrono::steady_clock::time_point start_;
+  bool is_recording_;
+
+ public:
+  /**
+   * \param label: Usually the #current_label() of the thread that created the task.
+   * \param grain_size: The grain size of the #parallel_for call, if any.
+   * \param size: The number of elements processed by the task, if known.
+   */
+  ScopedTask(const char *name, int label, int64_t grain_size = 0, int64_t size = 0);
+  ~ScopedTask();
+};
+
+/**
+ * Attribute all tasks created on the current thread to \a label while this object exists.
+ * The scope itself is recorded as well.
+ */
+class ScopedLabel {
+  int label_;
+  int previous_label_;
+  std::chrono::steady_clock::time_point start_;
+  bool is_recording_;
+
+ public:
+  ScopedLabel(StringRef label);
+  ~ScopedLabel();
+};
+
+}  // namespace blender::threading::profiler
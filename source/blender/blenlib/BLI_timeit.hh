@@ -13,6 +13,7 @@
 #include <string>
 
 #include "BLI_sys_types.h"
+#include "BLI_task_profiler.hh"
 
 namespace blender::timeit {
 
@@ -26,9 +27,11 @@ class ScopedTimer {
  private:
   std::string name_;
   TimePoint start_;
+  /** Attribute tasks started in this scope to the timer when profiling. */
+  threading::profiler::ScopedLabel profiler_label_;
 
  public:
-  ScopedTimer(std::string name) : name_(std::move(name))
+  ScopedTimer(std::string name) : name_(std::move(name)), profiler_label_(name_)
   {
     start_ = Clock::now();
   }
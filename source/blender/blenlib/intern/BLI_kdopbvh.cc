@@ -21,20 +21,29 @@
  *   #BLI_bvhtree_overlap, #BVHOverlapData_Shared, #BVHOverlapData_Thread
  * - Range Query:
  *   #BLI_bvhtree_range_query
+ * - Batched ray-cast queries:
+ *   #BLI_bvhtree_ray_cast_batch
  */
 
 #include <algorithm>
+#include <atomic>
 
 #include "MEM_guardedalloc.h"
 
 #include "BLI_alloca.h"
+#include "BLI_array.hh"
 #include "BLI_heap_simple.h"
+#include "BLI_index_mask.hh"
 #include "BLI_kdopbvh.hh"
 #include "BLI_math_geom.h"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_stack.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLI_strict_flags.h" /* IWYU pragma: keep. Keep last. */
 
@@ -845,6 +854,430 @@ static void non_recursive_bvh_div_nodes(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Binned SAH Tree Building
+ *
+ * Alternative to #non_recursive_bvh_div_nodes used with #BVH_BALANCE_SAH. A binary tree is built
+ * top-down, choosing each split among #BVH_SAH_BINS candidate planes per axis with the surface
+ * area heuristic. Sub-trees are built in parallel, as well as the binning of large nodes. The
+ * binary tree is then collapsed to the tree type, by repeatedly replacing the child with the
+ * largest surface area by its own children.
+ *
+ * Unlike the implicit tree, the number of branches depends on the distribution of the leafs, so
+ * the node arrays may have to be reallocated. Branches are still stored breadth-first so that all
+ * children have a greater index than their parent, which #BLI_bvhtree_update_tree relies on.
+ * \{ */
+
+#define BVH_SAH_BINS 16
+/** Nodes with more leafs than this are split in parallel. */
+#define BVH_SAH_THREAD_LEAF_THRESHOLD 4096
+/** Deeper than this, fall back to median splits to bound the recursion depth. */
+#define BVH_SAH_DEPTH_MAX 64
+
+struct BVHBuildNode {
+  /** Range of the leafs of this node in the leafs array. */
+  int leafs_begin;
+  int leafs_end;
+  /** Indices of the two children in the build nodes, -1 for leafs. */
+  int children[2];
+  /** Surface area of the bounds. */
+  float area;
+};
+
+struct BVHSAHBuildData {
+  MutableSpan<BVHNode *> leafs;
+  MutableSpan<BVHBuildNode> nodes;
+  std::atomic<int> nodes_num = 0;
+};
+
+struct BVHSAHBounds {
+  float3 min = float3(FLT_MAX);
+  float3 max = float3(-FLT_MAX);
+
+  void extend(const float3 &co)
+  {
+    this->min = math::min(this->min, co);
+    this->max = math::max(this->max, co);
+  }
+
+  void extend(const BVHSAHBounds &other)
+  {
+    this->min = math::min(this->min, other.min);
+    this->max = math::max(this->max, other.max);
+  }
+
+  bool is_empty() const
+  {
+    return this->min.x > this->max.x;
+  }
+
+  float area() const
+  {
+    if (this->is_empty()) {
+      return 0.0f;
+    }
+    const float3 size = this->max - this->min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+  }
+};
+
+/** Bounds of the leafs and of their centroids. */
+struct BVHSAHRangeBounds {
+  BVHSAHBounds bounds;
+  BVHSAHBounds centroids;
+};
+
+struct BVHSAHBins {
+  BVHSAHBounds bounds[3][BVH_SAH_BINS];
+  int count[3][BVH_SAH_BINS] = {};
+};
+
+static float3 bvh_leaf_centroid(const BVHNode *leaf)
+{
+  const float *bv = leaf->bv;
+  return float3(bv[0] + bv[1], bv[2] + bv[3], bv[4] + bv[5]) * 0.5f;
+}
+
+static BVHSAHBounds bvh_leaf_bounds(const BVHNode *leaf)
+{
+  const float *bv = leaf->bv;
+  BVHSAHBounds bounds;
+  bounds.min = float3(bv[0], bv[2], bv[4]);
+  bounds.max = float3(bv[1], bv[3], bv[5]);
+  return bounds;
+}
+
+static BVHSAHRangeBounds bvh_sah_range_bounds(const Span<BVHNode *> leafs)
+{
+  return threading::parallel_reduce(
+      leafs.index_range(),
+      BVH_SAH_THREAD_LEAF_THRESHOLD,
+      BVHSAHRangeBounds(),
+      [&](const IndexRange range, BVHSAHRangeBounds result) {
+        for (const BVHNode *leaf : leafs.slice(range)) {
+          result.bounds.extend(bvh_leaf_bounds(leaf));
+          result.centroids.extend(bvh_leaf_centroid(leaf));
+        }
+        return result;
+      },
+      [](BVHSAHRangeBounds a, const BVHSAHRangeBounds &b) {
+        a.bounds.extend(b.bounds);
+        a.centroids.extend(b.centroids);
+        return a;
+      });
+}
+
+static int bvh_sah_bin_index(const float value, const float min, const float bin_scale)
+{
+  return std::clamp(int((value - min) * bin_scale), 0, BVH_SAH_BINS - 1);
+}
+
+static BVHSAHBins bvh_sah_fill_bins(const Span<BVHNode *> leafs,
+                                    const BVHSAHBounds &centroid_bounds,
+                                    const float3 &bin_scale)
+{
+  return threading::parallel_reduce(
+      leafs.index_range(),
+      BVH_SAH_THREAD_LEAF_THRESHOLD,
+      BVHSAHBins(),
+      [&](const IndexRange range, BVHSAHBins bins) {
+        for (const BVHNode *leaf : leafs.slice(range)) {
+          const float3 centroid = bvh_leaf_centroid(leaf);
+          const BVHSAHBounds bounds = bvh_leaf_bounds(leaf);
+          for (int axis = 0; axis < 3; axis++) {
+            const int bin = bvh_sah_bin_index(
+                centroid[axis], centroid_bounds.min[axis], bin_scale[axis]);
+            bins.bounds[axis][bin].extend(bounds);
+            bins.count[axis][bin]++;
+          }
+        }
+        return bins;
+      },
+      [](BVHSAHBins a, const BVHSAHBins &b) {
+        for (int axis = 0; axis < 3; axis++) {
+          for (int bin = 0; bin < BVH_SAH_BINS; bin++) {
+            a.bounds[axis][bin].extend(b.bounds[axis][bin]);
+            a.count[axis][bin] += b.count[axis][bin];
+          }
+        }
+        return a;
+      });
+}
+
+/**
+ * Partition the leafs along the split plane with the lowest surface area heuristic cost.
+ * \return The number of leafs on the first side, 0 when no valid split was found.
+ */
+static int bvh_sah_partition(MutableSpan<BVHNode *> leafs, const BVHSAHBounds &centroid_bounds)
+{
+  const float3 extent = centroid_bounds.max - centroid_bounds.min;
+  float3 bin_scale;
+  for (int axis = 0; axis < 3; axis++) {
+    bin_scale[axis] = (extent[axis] > 0.0f) ? float(BVH_SAH_BINS) / extent[axis] : 0.0f;
+  }
+
+  const BVHSAHBins bins = bvh_sah_fill_bins(leafs, centroid_bounds, bin_scale);
+
+  float best_cost = FLT_MAX;
+  int best_axis = -1;
+  int best_bin = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    if (bin_scale[axis] == 0.0f) {
+      continue;
+    }
+    /* Sweep from the right to get the cost of the right side of every split plane. */
+    float right_cost[BVH_SAH_BINS];
+    BVHSAHBounds right_bounds;
+    int right_count = 0;
+    for (int bin = BVH_SAH_BINS - 1; bin > 0; bin--) {
+      right_bounds.extend(bins.bounds[axis][bin]);
+      right_count += bins.count[axis][bin];
+      right_cost[bin] = right_bounds.area() * float(right_count);
+    }
+    /* Sweep from the left, the split plane is between `bin - 1` and `bin`. */
+    BVHSAHBounds left_bounds;
+    int left_count = 0;
+    for (int bin = 1; bin < BVH_SAH_BINS; bin++) {
+      left_bounds.extend(bins.bounds[axis][bin - 1]);
+      left_count += bins.count[axis][bin - 1];
+      if (left_count == 0 || left_count == int(leafs.size())) {
+        continue;
+      }
+      const float cost = left_bounds.area() * float(left_count) + right_cost[bin];
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_bin = bin;
+      }
+    }
+  }
+
+  if (best_axis == -1) {
+    return 0;
+  }
+
+  BVHNode **mid = std::partition(leafs.begin(), leafs.end(), [&](const BVHNode *leaf) {
+    const float centroid = bvh_leaf_centroid(leaf)[best_axis];
+    return bvh_sah_bin_index(centroid, centroid_bounds.min[best_axis], bin_scale[best_axis]) <
+           best_bin;
+  });
+  return int(mid - leafs.begin());
+}
+
+static int bvh_sah_build_recursive(BVHSAHBuildData &data,
+                                   const int leafs_begin,
+                                   const int leafs_end,
+                                   const int depth)
+{
+  const int node_index = data.nodes_num.fetch_add(1, std::memory_order_relaxed);
+  BVHBuildNode &node = data.nodes[node_index];
+  node.leafs_begin = leafs_begin;
+  node.leafs_end = leafs_end;
+  node.children[0] = node.children[1] = -1;
+
+  const int leafs_num = leafs_end - leafs_begin;
+  MutableSpan<BVHNode *> leafs = data.leafs.slice(leafs_begin, leafs_num);
+  const BVHSAHRangeBounds range_bounds = bvh_sah_range_bounds(leafs);
+  node.area = range_bounds.bounds.area();
+
+  if (leafs_num == 1) {
+    return node_index;
+  }
+
+  int split = (depth < BVH_SAH_DEPTH_MAX) ? bvh_sah_partition(leafs, range_bounds.centroids) : 0;
+  if (split == 0) {
+    /* All centroids fall in the same bin, or the tree got too deep: use a median split. */
+    float bv[6];
+    for (int axis = 0; axis < 3; axis++) {
+      bv[2 * axis] = range_bounds.centroids.min[axis];
+      bv[2 * axis + 1] = range_bounds.centroids.max[axis];
+    }
+    split = leafs_num / 2;
+    partition_nth_element(
+        data.leafs.data(), leafs_begin, leafs_end, leafs_begin + split, get_largest_axis(bv) - 1);
+  }
+
+  threading::parallel_invoke(
+      leafs_num > BVH_SAH_THREAD_LEAF_THRESHOLD,
+      [&]() {
+        node.children[0] = bvh_sah_build_recursive(
+            data, leafs_begin, leafs_begin + split, depth + 1);
+      },
+      [&]() {
+        node.children[1] = bvh_sah_build_recursive(
+            data, leafs_begin + split, leafs_end, depth + 1);
+      });
+  return node_index;
+}
+
+/**
+ * Gather up to \a tree_type children for the branch of the build node \a node_index, opening the
+ * children with the largest surface area first.
+ */
+static int bvh_sah_collapse_children(const Span<BVHBuildNode> nodes,
+                                     const int node_index,
+                                     const int tree_type,
+                                     int r_children[MAX_TREETYPE])
+{
+  r_children[0] = nodes[node_index].children[0];
+  r_children[1] = nodes[node_index].children[1];
+  int children_num = 2;
+  while (children_num < tree_type) {
+    int best = -1;
+    float best_area = -1.0f;
+    for (int i = 0; i < children_num; i++) {
+      const BVHBuildNode &child = nodes[r_children[i]];
+      if (child.children[0] != -1 && child.area > best_area) {
+        best = i;
+        best_area = child.area;
+      }
+    }
+    if (best == -1) {
+      break;
+    }
+    const BVHBuildNode &child = nodes[r_children[best]];
+    r_children[best] = child.children[0];
+    r_children[children_num++] = child.children[1];
+  }
+  return children_num;
+}
+
+/**
+ * Make sure the node arrays can store \a branch_num branches after the leafs, reallocating them
+ * if needed. Leafs keep their position in #BVHTree.nodearray.
+ */
+static void bvhtree_ensure_branch_capacity(BVHTree *tree, const int branch_num)
+{
+  const int numnodes_old = int(MEM_allocN_len(tree->nodearray) / sizeof(BVHNode));
+  const int numnodes = tree->leaf_num + branch_num + tree->tree_type;
+  if (numnodes <= numnodes_old) {
+    return;
+  }
+
+  BVHNode *nodearray_old = tree->nodearray;
+  tree->nodes = static_cast<BVHNode **>(
+      MEM_recallocN(tree->nodes, sizeof(BVHNode *) * size_t(numnodes)));
+  tree->nodebv = static_cast<float *>(
+      MEM_recallocN(tree->nodebv, sizeof(float) * size_t(tree->axis) * size_t(numnodes)));
+  tree->nodechild = static_cast<BVHNode **>(MEM_recallocN(
+      tree->nodechild, sizeof(BVHNode *) * size_t(tree->tree_type) * size_t(numnodes)));
+  tree->nodearray = static_cast<BVHNode *>(
+      MEM_recallocN(tree->nodearray, sizeof(BVHNode) * size_t(numnodes)));
+
+  for (int i = 0; i < numnodes; i++) {
+    tree->nodearray[i].bv = &tree->nodebv[i * tree->axis];
+    tree->nodearray[i].children = &tree->nodechild[i * tree->tree_type];
+  }
+  for (int i = 0; i < tree->leaf_num; i++) {
+    tree->nodes[i] = tree->nodearray + (tree->nodes[i] - nodearray_old);
+  }
+}
+
+static void bvhtree_sah_build(BVHTree *tree)
+{
+  const int leaf_num = tree->leaf_num;
+  const int tree_type = tree->tree_type;
+
+  /* A binary tree with one leaf per node. */
+  Array<BVHBuildNode> build_nodes(2 * leaf_num - 1);
+  BVHSAHBuildData data;
+  data.leafs = MutableSpan<BVHNode *>(tree->nodes, leaf_num);
+  data.nodes = build_nodes;
+  bvh_sah_build_recursive(data, 0, leaf_num, 0);
+  BLI_assert(data.nodes_num == build_nodes.size());
+
+  /* Collapse breadth-first, storing the children of each branch. */
+  Vector<int> branch_build_nodes = {0};
+  Vector<int> branch_children;
+  Vector<int> branch_children_num;
+  for (int i = 0; i < branch_build_nodes.size(); i++) {
+    int children[MAX_TREETYPE];
+    const int children_num = bvh_sah_collapse_children(
+        build_nodes, branch_build_nodes[i], tree_type, children);
+    for (int k = 0; k < children_num; k++) {
+      if (build_nodes[children[k]].children[0] != -1) {
+        branch_build_nodes.append(children[k]);
+      }
+    }
+    branch_children.extend(Span(children, children_num));
+    branch_children_num.append(children_num);
+  }
+
+  const int branch_num = int(branch_build_nodes.size());
+  bvhtree_ensure_branch_capacity(tree, branch_num);
+  BVHNode *branches = tree->nodearray + leaf_num;
+
+  int next_branch = 1;
+  int children_offset = 0;
+  branches[0].parent = nullptr;
+  for (int i = 0; i < branch_num; i++) {
+    BVHNode *branch = &branches[i];
+    const int children_num = branch_children_num[i];
+    for (int k = 0; k < tree_type; k++) {
+      if (k >= children_num) {
+        branch->children[k] = nullptr;
+        continue;
+      }
+      const BVHBuildNode &child = build_nodes[branch_children[children_offset + k]];
+      BVHNode *child_node = (child.children[0] == -1) ? tree->nodes[child.leafs_begin] :
+                                                        &branches[next_branch++];
+      child_node->parent = branch;
+      branch->children[k] = child_node;
+    }
+    branch->node_num = char(children_num);
+    children_offset += children_num;
+    tree->nodes[leaf_num + i] = branch;
+  }
+  BLI_assert(next_branch == branch_num);
+  tree->branch_num = branch_num;
+
+  /* Bottom-up bounds, then sort the children along the largest axis like the implicit tree does
+   * for the traversal heuristics. */
+  for (int i = branch_num - 1; i >= 0; i--) {
+    BVHNode *branch = &branches[i];
+    node_join(tree, branch);
+    branch->main_axis = char(get_largest_axis(branch->bv) / 2);
+    const int sort_axis = branch->main_axis * 2;
+    bvh_insertionsort(branch->children, 0, branch->node_num, sort_axis);
+  }
+}
+
+/** Surface area heuristic with unit traversal and intersection costs. */
+static float bvhtree_sah_cost(const BVHTree *tree)
+{
+  if (tree->leaf_num + tree->branch_num == 0) {
+    return 0.0f;
+  }
+  const BVHNode *root = tree->nodes[tree->leaf_num];
+  const float root_area = bvh_leaf_bounds(root).area();
+  if (root_area == 0.0f) {
+    return 0.0f;
+  }
+
+  float cost = 0.0f;
+  for (int i = 0; i < tree->leaf_num + tree->branch_num; i++) {
+    cost += bvh_leaf_bounds(tree->nodes[i]).area() / root_area;
+  }
+  return cost;
+}
+
+static void bvhtree_build_stats_calc(const BVHTree *tree, BVHTreeBuildStats *r_stats)
+{
+  r_stats->branches_num = tree->branch_num;
+  r_stats->depth_max = 0;
+  r_stats->sah_cost = bvhtree_sah_cost(tree);
+
+  for (int i = 0; i < tree->leaf_num; i++) {
+    int depth = 0;
+    for (const BVHNode *parent = tree->nodes[i]->parent; parent; parent = parent->parent) {
+      depth++;
+    }
+    r_stats->depth_max = std::max(r_stats->depth_max, depth);
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree API
  * \{ */
@@ -931,7 +1364,7 @@ void BLI_bvhtree_free(BVHTree *tree)
   }
 }
 
-void BLI_bvhtree_balance(BVHTree *tree)
+void BLI_bvhtree_balance_ex(BVHTree *tree, const int flag, BVHTreeBuildStats *r_stats)
 {
   BVHNode **leafs_array = tree->nodes;
 
@@ -939,15 +1372,28 @@ void BLI_bvhtree_balance(BVHTree *tree)
    * (some big bug goes here if its being called more than once per tree) */
   BLI_assert(tree->branch_num == 0);
 
-  /* Build the implicit tree */
-  non_recursive_bvh_div_nodes(
-      tree, tree->nodearray + (tree->leaf_num - 1), leafs_array, tree->leaf_num);
+  const double time_start = r_stats ? BLI_time_now_seconds() : 0.0;
 
-  /* current code expects the branches to be linked to the nodes array
-   * we perform that linkage here */
-  tree->branch_num = implicit_needed_branches(tree->tree_type, tree->leaf_num);
-  for (int i = 0; i < tree->branch_num; i++) {
-    tree->nodes[tree->leaf_num + i] = &tree->nodearray[tree->leaf_num + i];
+  /* The SAH builder only works with the X, Y and Z axes, and on at least two leafs. */
+  if ((flag & BVH_BALANCE_SAH) && tree->start_axis == 0 && tree->leaf_num > 1) {
+    bvhtree_sah_build(tree);
+  }
+  else {
+    /* Build the implicit tree */
+    non_recursive_bvh_div_nodes(
+        tree, tree->nodearray + (tree->leaf_num - 1), leafs_array, tree->leaf_num);
+
+    /* current code expects the branches to be linked to the nodes array
+     * we perform that linkage here */
+    tree->branch_num = implicit_needed_branches(tree->tree_type, tree->leaf_num);
+    for (int i = 0; i < tree->branch_num; i++) {
+      tree->nodes[tree->leaf_num + i] = &tree->nodearray[tree->leaf_num + i];
+    }
+  }
+
+  if (r_stats) {
+    r_stats->build_time = BLI_time_now_seconds() - time_start;
+    bvhtree_build_stats_calc(tree, r_stats);
   }
 
 #ifdef USE_SKIP_LINKS
@@ -963,6 +1409,11 @@ void BLI_bvhtree_balance(BVHTree *tree)
 #endif
 }
 
+void BLI_bvhtree_balance(BVHTree *tree)
+{
+  BLI_bvhtree_balance_ex(tree, 0, nullptr);
+}
+
 static void bvhtree_node_inflate(const BVHTree *tree, BVHNode *node, const float dist)
 {
   axis_t axis_iter;
@@ -1028,6 +1479,91 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
     node_join(tree, *index);
   }
 }
+
+BVHTree *BLI_bvhtree_copy(const BVHTree *tree)
+{
+  BVHTree *tree_copy = static_cast<BVHTree *>(MEM_dupallocN(tree));
+  tree_copy->nodes = static_cast<BVHNode **>(MEM_dupallocN(tree->nodes));
+  tree_copy->nodearray = static_cast<BVHNode *>(MEM_dupallocN(tree->nodearray));
+  tree_copy->nodechild = static_cast<BVHNode **>(MEM_dupallocN(tree->nodechild));
+  tree_copy->nodebv = static_cast<float *>(MEM_dupallocN(tree->nodebv));
+
+  /* All node pointers point into the pre-allocated arrays, rebase them on the copies. */
+  const auto rebase = [&](BVHNode *node) -> BVHNode * {
+    return node ? tree_copy->nodearray + (node - tree->nodearray) : nullptr;
+  };
+  const int nodes_num = int(MEM_allocN_len(tree->nodearray) / sizeof(BVHNode));
+  for (int i = 0; i < nodes_num; i++) {
+    BVHNode &node = tree_copy->nodearray[i];
+    node.bv = tree_copy->nodebv + (node.bv - tree->nodebv);
+    node.children = tree_copy->nodechild + (node.children - tree->nodechild);
+    node.parent = rebase(node.parent);
+#ifdef USE_SKIP_LINKS
+    node.skip[0] = rebase(node.skip[0]);
+    node.skip[1] = rebase(node.skip[1]);
+#endif
+  }
+  const int children_num = int(MEM_allocN_len(tree->nodechild) / sizeof(BVHNode *));
+  for (int i = 0; i < children_num; i++) {
+    tree_copy->nodechild[i] = rebase(tree_copy->nodechild[i]);
+  }
+  for (int i = 0; i < tree->leaf_num + tree->branch_num; i++) {
+    tree_copy->nodes[i] = rebase(tree_copy->nodes[i]);
+  }
+  return tree_copy;
+}
+
+/** Below this depth, branches are refitted on a single thread. */
+#define KDOPBVH_REFIT_PARALLEL_DEPTH 4
+
+static void bvhtree_refit_branch(BVHTree *tree, BVHNode *node, const int depth)
+{
+  const auto refit_child = [&](const int64_t i) {
+    BVHNode *child = node->children[i];
+    /* Leafs have been updated already. */
+    if (child->node_num != 0) {
+      bvhtree_refit_branch(tree, child, depth + 1);
+    }
+  };
+  if (depth < KDOPBVH_REFIT_PARALLEL_DEPTH) {
+    threading::parallel_for(IndexRange(node->node_num), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        refit_child(i);
+      }
+    });
+  }
+  else {
+    for (int i = 0; i < node->node_num; i++) {
+      refit_child(i);
+    }
+  }
+  node_join(tree, node);
+}
+
+void BLI_bvhtree_refit(BVHTree &tree, const int points_num, BVHTree_RefitCallback fn)
+{
+  BLI_assert(points_num > 0);
+  threading::parallel_for(IndexRange(tree.leaf_num), 1024, [&](const IndexRange range) {
+    Array<float3, 4> points(points_num);
+    for (const int64_t i : range) {
+      BVHNode *leaf = tree.nodes[i];
+      fn(leaf->index, points);
+      create_kdop_hull(
+          &tree, leaf, reinterpret_cast<const float *>(points.data()), points_num, 0);
+      bvhtree_node_inflate(&tree, leaf, tree.epsilon);
+    }
+  });
+
+  if (tree.branch_num > 0) {
+    bvhtree_refit_branch(&tree, tree.nodes[tree.leaf_num], 0);
+  }
+}
+
+float BLI_bvhtree_sah_cost(const BVHTree &tree)
+{
+  BLI_assert(tree.start_axis == 0);
+  return bvhtree_sah_cost(&tree);
+}
 int BLI_bvhtree_get_len(const BVHTree *tree)
 {
   return tree->leaf_num;
@@ -1525,7 +2061,9 @@ int *BLI_bvhtree_intersect_plane(const BVHTree *tree, float plane[4], uint *r_in
 
 /* Determines the nearest point of the given node BV.
  * Returns the squared distance to that point. */
-static float calc_nearest_point_squared(const float proj[3], BVHNode *node, float nearest[3])
+static float calc_nearest_point_squared(const float proj[3],
+                                        const BVHNode *node,
+                                        float nearest[3])
 {
   int i;
   const float *bv = node->bv;
@@ -2383,4 +2921,186 @@ int BLI_bvhtree_find_nearest_projected(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree batched queries
+ *
+ * Process many queries against the same tree, in parallel. Compared to the single query
+ * functions, the traversal uses an explicit stack that is reused across the queries of a thread,
+ * the bounds of all children of a node are tested in a single branch-free loop, and the children
+ * are visited front-to-back, which prunes more of the tree than the split axis heuristic of the
+ * recursive traversals. The closest child is descended into directly, without going through the
+ * stack.
+ * \{ */
+
+/** Minimum number of queries processed by a single task. */
+#define KDOPBVH_BATCH_GRAIN_SIZE 256
+
+struct BVHStackItem {
+  const BVHNode *node;
+  /** Distance to the bounds of the node when it was pushed, used to skip it once a closer
+   * result has been found. */
+  float dist;
+};
+
+using BVHTraversalStack = Vector<BVHStackItem, 64>;
+
+/**
+ * Push the children of \a node with a distance smaller than \a dist_max to \a stack, sorted so
+ * that the closest one is on top. The closest child is popped again right away and returned, so
+ * that the traversal can descend into it directly. Its node is null when all children are too far.
+ */
+static BVHStackItem bvh_stack_push_children_sorted(BVHTraversalStack &stack,
+                                                   const BVHNode *node,
+                                                   const float dist[MAX_TREETYPE],
+                                                   const float dist_max)
+{
+  const int64_t start = stack.size();
+  for (int i = 0; i < node->node_num; i++) {
+    if (dist[i] >= dist_max) {
+      continue;
+    }
+    stack.append({node->children[i], dist[i]});
+    for (int64_t j = stack.size() - 1; j > start && stack[j - 1].dist < stack[j].dist; j--) {
+      std::swap(stack[j - 1], stack[j]);
+    }
+  }
+  if (stack.size() == start) {
+    return {nullptr, 0.0f};
+  }
+  return stack.pop_last();
+}
+
+/**
+ * Pop the next node that is still closer than \a dist_max, skipping the others.
+ */
+static BVHStackItem bvh_stack_pop(BVHTraversalStack &stack, const float dist_max)
+{
+  while (!stack.is_empty()) {
+    const BVHStackItem item = stack.pop_last();
+    if (item.dist < dist_max) {
+      return item;
+    }
+  }
+  return {nullptr, 0.0f};
+}
+
+/**
+ * Compute the distances along the ray to the bounds of all children of \a node, #FLT_MAX for
+ * children that are missed. Gives the same results as #fast_ray_nearest_hit on each child.
+ */
+static void ray_children_nearest_hit(const BVHRayCastData &data,
+                                     const BVHNode *node,
+                                     float r_dist[MAX_TREETYPE])
+{
+  const int children_num = node->node_num;
+  if (data.ray.radius != 0.0f) {
+    for (int i = 0; i < children_num; i++) {
+      r_dist[i] = ray_nearest_hit(&data, node->children[i]->bv);
+    }
+    return;
+  }
+
+  /* Gather the bounds first, so that the intersection loop below only works on contiguous
+   * arrays. */
+  float bv_near[3][MAX_TREETYPE];
+  float bv_far[3][MAX_TREETYPE];
+  for (int i = 0; i < children_num; i++) {
+    const float *bv = node->children[i]->bv;
+    for (int axis = 0; axis < 3; axis++) {
+      bv_near[axis][i] = bv[data.index[2 * axis]];
+      bv_far[axis][i] = bv[data.index[2 * axis + 1]];
+    }
+  }
+
+  for (int i = 0; i < children_num; i++) {
+    const float t1x = (bv_near[0][i] - data.ray.origin[0]) * data.idot_axis[0];
+    const float t2x = (bv_far[0][i] - data.ray.origin[0]) * data.idot_axis[0];
+    const float t1y = (bv_near[1][i] - data.ray.origin[1]) * data.idot_axis[1];
+    const float t2y = (bv_far[1][i] - data.ray.origin[1]) * data.idot_axis[1];
+    const float t1z = (bv_near[2][i] - data.ray.origin[2]) * data.idot_axis[2];
+    const float t2z = (bv_far[2][i] - data.ray.origin[2]) * data.idot_axis[2];
+    const float t_near = std::max(std::max(t1x, t1y), t1z);
+    const float t_far = std::min(std::min(t2x, t2y), t2z);
+    const bool is_hit = (t_near <= t_far) && (t_far >= 0.0f) && (t_near <= data.hit.dist);
+    r_dist[i] = is_hit ? t_near : FLT_MAX;
+  }
+}
+
+template<typename LeafFn>
+static void bvhtree_ray_cast_stack(BVHRayCastData &data,
+                                   const BVHNode *root,
+                                   BVHTraversalStack &stack,
+                                   const LeafFn &leaf_fn)
+{
+  const float root_dist = (data.ray.radius == 0.0f) ? fast_ray_nearest_hit(&data, root) :
+                                                      ray_nearest_hit(&data, root->bv);
+  if (root_dist >= data.hit.dist) {
+    return;
+  }
+
+  float dist[MAX_TREETYPE];
+  stack.clear();
+  BVHStackItem item = {root, root_dist};
+  while (item.node) {
+    if (item.node->node_num == 0) {
+      leaf_fn(item.node, item.dist);
+      item.node = nullptr;
+    }
+    else {
+      ray_children_nearest_hit(data, item.node, dist);
+      item = bvh_stack_push_children_sorted(stack, item.node, dist, data.hit.dist);
+    }
+    if (item.node == nullptr) {
+      item = bvh_stack_pop(stack, data.hit.dist);
+    }
+  }
+}
+
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                const Span<float3> ray_origins,
+                                const Span<float3> ray_directions,
+                                const float radius,
+                                MutableSpan<BVHTreeRayHit> r_hits,
+                                const BVHTree_RayCastCallback_CPP fn,
+                                const int flag)
+{
+  const BVHNode *root = tree.nodes[tree.leaf_num];
+  if (root == nullptr) {
+    return;
+  }
+
+  mask.foreach_segment(GrainSize(KDOPBVH_BATCH_GRAIN_SIZE), [&](const IndexMaskSegment segment) {
+    BVHTraversalStack stack;
+    BVHRayCastData data;
+    data.tree = &tree;
+    data.callback = nullptr;
+    data.userdata = nullptr;
+    data.ray.radius = radius;
+
+    for (const int64_t i : segment) {
+      BLI_ASSERT_UNIT_V3(ray_directions[i]);
+      copy_v3_v3(data.ray.origin, ray_origins[i]);
+      copy_v3_v3(data.ray.direction, ray_directions[i]);
+      bvhtree_ray_cast_data_precalc(&data, flag);
+      data.hit = r_hits[i];
+
+      bvhtree_ray_cast_stack(data, root, stack, [&](const BVHNode *leaf, const float dist) {
+        if (fn) {
+          fn(leaf->index, data.ray, data.hit);
+        }
+        else {
+          data.hit.index = leaf->index;
+          data.hit.dist = dist;
+          madd_v3_v3v3fl(data.hit.co, data.ray.origin, data.ray.direction, dist);
+        }
+      });
+
+      r_hits[i] = data.hit;
+    }
+  });
+}
+
+/** \} */
+
 }  // namespace blender
@@ -471,6 +471,32 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
   return !file->io_error;
 }
 
+void BLI_mmap_release_range(BLI_mmap_file *file, size_t offset, size_t length)
+{
+  if (file->io_error || (offset + length > file->length)) {
+    return;
+  }
+#ifndef WIN32
+  static const size_t page_size = size_t(sysconf(_SC_PAGESIZE));
+  /* Only release pages that are fully contained in the range, the ones at the boundaries may
+   * still be used by the data before or after it. */
+  const uintptr_t begin = uintptr_t(file->memory + offset);
+  const uintptr_t end = uintptr_t(file->memory + offset + length);
+  const uintptr_t begin_aligned = (begin + page_size - 1) & ~uintptr_t(page_size - 1);
+  const uintptr_t end_aligned = end & ~uintptr_t(page_size - 1);
+  if (begin_aligned >= end_aligned) {
+    return;
+  }
+  /* The mapping is private and read-only, so its pages are never modified and dropping them is
+   * always safe: they are read back from the file when accessed again. */
+  madvise(reinterpret_cast<void *>(begin_aligned), end_aligned - begin_aligned, MADV_DONTNEED);
+#else
+  /* Releasing individual pages of a mapped view is not supported, the system trims the working
+   * set of the process when needed. */
+  UNUSED_VARS(file, offset, length);
+#endif
+}
+
 void *BLI_mmap_get_pointer(BLI_mmap_file *file)
 {
   return file->memory;
@@ -268,6 +268,22 @@ int64_t count_booleans(const VArray<bool> &varray)
   return count_booleans(varray, IndexMask(varray.size()));
 }
 
+void fill_zero_numa(void *data, const int64_t size_in_bytes)
+{
+  /* Pages are the granularity at which memory is placed on NUMA nodes. */
+  const int64_t page_size = 4096;
+  if (threading::numa_nodes_num() == 1 || size_in_bytes < 64 * page_size) {
+    memset(data, 0, size_t(size_in_bytes));
+    return;
+  }
+  const int64_t pages_num = int64_t(divide_ceil_ul(uint64_t(size_in_bytes), page_size));
+  threading::parallel_for_numa(IndexRange(pages_num), 16, [&](const IndexRange pages) {
+    const IndexRange bytes = IndexRange::from_begin_end(
+        pages.start() * page_size, std::min(pages.one_after_last() * page_size, size_in_bytes));
+    memset(static_cast<char *>(data) + bytes.start(), 0, size_t(bytes.size()));
+  });
+}
+
 bool indices_are_range(Span<int> indices, IndexRange range)
 {
   if (indices.size() != range.size()) {
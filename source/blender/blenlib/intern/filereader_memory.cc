@@ -90,6 +90,9 @@ FileReader *BLI_filereader_new_memory(const void *data, size_t len)
  * This avoids system call overhead and can significantly speed up file loading.
  */
 
+/** Minimum size of a single read for the mapped pages to be released right after copying them. */
+#define MMAP_RELEASE_READ_SIZE_MIN (1 << 20)
+
 static int64_t memory_read_mmap(FileReader *reader, void *buffer, size_t size)
 {
   MemoryReader *mem = reinterpret_cast<MemoryReader *>(reader);
@@ -101,6 +104,13 @@ static int64_t memory_read_mmap(FileReader *reader, void *buffer, size_t size)
     return 0;
   }
 
+  /* Large reads are typically bulk data (e.g. mesh attribute arrays) that is copied once into
+   * its final buffer. Keeping the mapped pages resident as well would double the memory usage
+   * for that data, so let the system release them. */
+  if (readsize >= MMAP_RELEASE_READ_SIZE_MIN) {
+    BLI_mmap_release_range(mem->mmap, mem->reader.offset, readsize);
+  }
+
   mem->reader.offset += readsize;
 
   return readsize;
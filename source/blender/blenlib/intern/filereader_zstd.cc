@@ -17,6 +17,24 @@
 
 namespace blender {
 
+/**
+ * Number of decompressed frames kept in memory by the seekable reader.
+ *
+ * Reading a .blend file does not access its content purely sequentially: data blocks are read on
+ * demand (see `USE_BHEAD_READ_ON_DEMAND` in `readfile.cc`), and linking from a library jumps
+ * around the file. Keeping a few frames around avoids decompressing the same frame over and
+ * over when going back and forth between them.
+ */
+#define ZSTD_SEEK_CACHE_SIZE 8
+
+struct ZstdFrameCache {
+  /** Index of the cached frame, -1 when the slot is unused. */
+  int frame;
+  /** Value of #ZstdReader::seek::cache_tick when this frame was last accessed. */
+  uint64_t last_used;
+  char *content;
+};
+
 struct ZstdReader {
   FileReader reader;
 
@@ -31,8 +49,8 @@ struct ZstdReader {
     size_t *compressed_ofs;
     size_t *uncompressed_ofs;
 
-    char *cached_content;
-    int cached_frame;
+    ZstdFrameCache cache[ZSTD_SEEK_CACHE_SIZE];
+    uint64_t cache_tick;
   } seek;
 };
 
@@ -127,7 +145,9 @@ static bool zstd_read_seek_table(ZstdReader *zstd)
     return false;
   }
 
-  zstd->seek.cached_frame = -1;
+  for (ZstdFrameCache &cache : zstd->seek.cache) {
+    cache.frame = -1;
+  }
 
   return true;
 }
@@ -155,16 +175,28 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
+/* Ensure that the given frame is loaded in the cache, and return its content. */
 static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
+  zstd->seek.cache_tick++;
+
+  /* Find the frame in the cache, or else the least recently used slot to replace. */
+  ZstdFrameCache *lru_cache = &zstd->seek.cache[0];
+  for (ZstdFrameCache &cache : zstd->seek.cache) {
+    if (cache.frame == frame) {
+      /* Cached frame matches, so just return it. */
+      cache.last_used = zstd->seek.cache_tick;
+      return cache.content;
+    }
+    if (cache.last_used < lru_cache->last_used) {
+      lru_cache = &cache;
+    }
   }
 
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
+  /* Frame is not cached, so discard the least recently used one and cache the wanted one
+   * instead. */
+  MEM_SAFE_FREE(lru_cache->content);
+  lru_cache->frame = -1;
 
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
   size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
@@ -188,8 +220,9 @@ static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
     return nullptr;
   }
 
-  zstd->seek.cached_frame = frame;
-  zstd->seek.cached_content = uncompressed_data;
+  lru_cache->frame = frame;
+  lru_cache->last_used = zstd->seek.cache_tick;
+  lru_cache->content = uncompressed_data;
   return uncompressed_data;
 }
 
@@ -285,9 +318,11 @@ static void zstd_close(FileReader *reader)
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
-    /* When an error has occurred this may be nullptr, see: #99744. */
-    if (zstd->seek.cached_content) {
-      MEM_freeN(zstd->seek.cached_content);
+    for (ZstdFrameCache &cache : zstd->seek.cache) {
+      /* When an error has occurred this may be nullptr, see: #99744. */
+      if (cache.content) {
+        MEM_freeN(cache.content);
+      }
     }
   }
   else {
@@ -0,0 +1,15 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ *
+ * Color space conversion kernels compiled with AVX2 flags, see #BLI_SIMD_DISPATCH.
+ */
+
+#define BLI_SIMD_ARCH_NAMESPACE avx2
+
+#include "BLI_simd.hh"
+
+#include "math_color_simd.hh"
@@ -0,0 +1,153 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ *
+ * Color space conversions with pow 2.4 and 1/2.4 approximations, written once for #simd::vfloat4
+ * and #simd::vfloat8. Included exactly once per instruction set: by `math_color.cc` for the
+ * baseline and by `math_color_avx2.cc` and `math_color_avx512.cc`.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "BLI_simd.hh"
+
+BLI_SIMD_DECLARE_KERNEL(void,
+                        srgb_to_linearrgb_v4_array,
+                        (float (*linear)[4], const float (*srgb)[4], size_t num))
+BLI_SIMD_DECLARE_KERNEL(void,
+                        linearrgb_to_srgb_v4_array,
+                        (float (*srgb)[4], const float (*linear)[4], size_t num))
+
+namespace blender::simd {
+inline namespace BLI_SIMD_ARCH_NAMESPACE {
+
+/**
+ * Calculate initial guess for `arg^exp` based on float representation
+ * This method gives a constant bias, which can be easily compensated by
+ * multiplying with bias_coeff.
+ * Gives better results for exponents near 1 (e.g. `4/5`).
+ * exp = exponent, encoded as uint32_t
+ * `e2coeff = 2^(127/exponent - 127) * bias_coeff^(1/exponent)`, encoded as `uint32_t`.
+ *
+ * We hope that exp and e2coeff gets properly inlined.
+ */
+template<typename V> MALWAYS_INLINE V fastpow(const int exp, const int e2coeff, const V arg)
+{
+  V ret = arg * V::from_bits(e2coeff);
+  ret = float_from_int_bits(ret);
+  ret = ret * V::from_bits(exp);
+  return int_bits_from_float(ret);
+}
+
+/** Improve `x ^ 1.0f/5.0f` solution with Newton-Raphson method */
+template<typename V> MALWAYS_INLINE V improve_5throot_solution(const V old_result, const V x)
+{
+  const V approx2 = old_result * old_result;
+  const V approx4 = approx2 * approx2;
+  const V t = x / approx4;
+  const V summ = V(4.0f) * old_result + t; /* FMA. */
+  return summ * V(1.0f / 5.0f);
+}
+
+/** Calculate `powf(x, 2.4)`. Working domain: `1e-10 < x < 1e+10`. */
+template<typename V> MALWAYS_INLINE V fastpow24(const V arg)
+{
+  /* max, avg and |avg| errors were calculated in GCC without FMA instructions
+   * The final precision should be better than `powf` in GLIBC. */
+
+  /* Calculate x^4/5, coefficient 0.994 was constructed manually to minimize
+   * avg error.
+   */
+  /* 0x3F4CCCCD = 4/5 */
+  /* 0x4F55A7FB = 2^(127/(4/5) - 127) * 0.994^(1/(4/5)) */
+  /* error max = 0.17, avg = 0.0018, |avg| = 0.05 */
+  V x = fastpow(0x3F4CCCCD, 0x4F55A7FB, arg);
+  const V arg2 = arg * arg;
+  const V arg4 = arg2 * arg2;
+  /* error max = 0.018        avg = 0.0031    |avg| = 0.0031 */
+  x = improve_5throot_solution(x, arg4);
+  /* error max = 0.00021    avg = 1.6e-05    |avg| = 1.6e-05 */
+  x = improve_5throot_solution(x, arg4);
+  /* error max = 6.1e-07    avg = 5.2e-08    |avg| = 1.1e-07 */
+  x = improve_5throot_solution(x, arg4);
+  return x * (x * x);
+}
+
+/* Calculate `powf(x, 1.0f / 2.4)`. */
+template<typename V> MALWAYS_INLINE V fastpow512(const V arg)
+{
+  /* 5/12 is too small, so compute the 4th root of 20/12 instead.
+   * 20/12 = 5/3 = 1 + 2/3 = 2 - 1/3. 2/3 is a suitable argument for fastpow.
+   * weighting coefficient: a^-1/2 = 2 a; a = 2^-2/3
+   */
+  const V xf = fastpow(0x3f2aaaab, 0x5eb504f3, arg);
+  const V xover = arg * xf;
+  const V xfm1 = rsqrt(xf);
+  const V x2 = arg * arg;
+  const V xunder = x2 * xfm1;
+  /* sqrt2 * over + 2 * sqrt2 * under */
+  V xavg = V(1.0f / (3.0f * 0.629960524947437f) * 0.999852f) * (xover + xunder);
+  xavg = xavg * rsqrt(xavg);
+  xavg = xavg * rsqrt(xavg);
+  return xavg;
+}
+
+template<typename V> MALWAYS_INLINE V srgb_to_linearrgb(const V c)
+{
+  const V cmp = c < V(0.04045f);
+  const V lt = max(c * V(1.0f / 12.92f), V(0.0f));
+  const V gtebase = (c + V(0.055f)) * V(1.0f / 1.055f); /* FMA. */
+  const V gte = fastpow24(gtebase);
+  return select(cmp, lt, gte);
+}
+
+template<typename V> MALWAYS_INLINE V linearrgb_to_srgb(const V c)
+{
+  const V cmp = c < V(0.0031308f);
+  const V lt = max(c * V(12.92f), V(0.0f));
+  const V gte = V(1.055f) * fastpow512(c) + V(-0.055f);
+  return select(cmp, lt, gte);
+}
+
+/**
+ * Apply a conversion to the RGB channels of RGBA pixels, two at a time. The alpha values are read
+ * first, so that the conversion can be done in place.
+ */
+template<typename Fn>
+MALWAYS_INLINE void rgba_array_convert(float (*dst)[4],
+                                       const float (*src)[4],
+                                       const size_t num,
+                                       const Fn &fn)
+{
+  size_t i = 0;
+  for (; i + 2 <= num; i += 2) {
+    const float alpha_a = src[i][3];
+    const float alpha_b = src[i + 1][3];
+    fn(vfloat8::load(src[i])).store(dst[i]);
+    dst[i][3] = alpha_a;
+    dst[i + 1][3] = alpha_b;
+  }
+  if (i < num) {
+    const float alpha = src[i][3];
+    fn(vfloat4::load(src[i])).store(dst[i]);
+    dst[i][3] = alpha;
+  }
+}
+
+void srgb_to_linearrgb_v4_array(float (*linear)[4], const float (*srgb)[4], const size_t num)
+{
+  rgba_array_convert(linear, srgb, num, [](const auto c) { return srgb_to_linearrgb(c); });
+}
+
+void linearrgb_to_srgb_v4_array(float (*srgb)[4], const float (*linear)[4], const size_t num)
+{
+  rgba_array_convert(srgb, linear, num, [](const auto c) { return linearrgb_to_srgb(c); });
+}
+
+}  // namespace BLI_SIMD_ARCH_NAMESPACE
+}  // namespace blender::simd
@@ -0,0 +1,208 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <atomic>
+
+#include "BLI_math_base.h"
+#include "BLI_scratch_allocator.hh"
+#include "BLI_utildefines.h"
+
+namespace blender {
+
+/** Size of all chunks of all threads, for #scratch_allocator_memory_in_use. */
+static std::atomic<int64_t> chunks_size_total = 0;
+
+namespace {
+
+/**
+ * Stored in front of every allocation, to know where the memory came from when it is freed.
+ */
+struct ScratchHeader {
+  /** Offset from the start of the guarded allocation, or zero for memory from an arena. */
+  int64_t heap_offset;
+  /** Size of the allocation, used to give back the most recent allocation of an arena. */
+  int64_t size;
+};
+
+struct ScratchChunk {
+  void *buffer;
+  int64_t size;
+};
+
+/**
+ * The chunks are allocated with #RawAllocator, because the arena of the main thread is only
+ * freed after the guarded allocator checked for leaks. Their size is counted separately instead.
+ */
+struct ScratchArena {
+  RawVector<ScratchChunk> chunks;
+  /** Chunk that allocations are currently taken from, -1 before the first allocation. */
+  int64_t chunk_index = -1;
+  uintptr_t current = 0;
+  uintptr_t end = 0;
+  int scopes_num = 0;
+
+  ~ScratchArena()
+  {
+    for (const ScratchChunk &chunk : this->chunks) {
+      free_chunk(chunk);
+    }
+  }
+
+  static ScratchChunk allocate_chunk(const int64_t size)
+  {
+    chunks_size_total.fetch_add(size, std::memory_order_relaxed);
+    return {RawAllocator().allocate(size_t(size), 64, __func__), size};
+  }
+
+  static void free_chunk(const ScratchChunk &chunk)
+  {
+    chunks_size_total.fetch_sub(chunk.size, std::memory_order_relaxed);
+    RawAllocator().deallocate(chunk.buffer);
+  }
+
+  void *allocate(const int64_t size, const int64_t alignment)
+  {
+    uintptr_t begin = this->aligned_begin(alignment);
+    if (this->chunk_index == -1 || begin + uintptr_t(size) > this->end) {
+      this->use_next_chunk(size + alignment + int64_t(sizeof(ScratchHeader)));
+      begin = this->aligned_begin(alignment);
+    }
+    ScratchHeader *header = reinterpret_cast<ScratchHeader *>(begin) - 1;
+    header->heap_offset = 0;
+    header->size = size;
+    this->current = begin + uintptr_t(size);
+    return reinterpret_cast<void *>(begin);
+  }
+
+  uintptr_t aligned_begin(const int64_t alignment) const
+  {
+    const uintptr_t mask = uintptr_t(alignment) - 1;
+    return (this->current + sizeof(ScratchHeader) + mask) & ~mask;
+  }
+
+  void use_next_chunk(const int64_t min_size)
+  {
+    /* Start small, so that threads that only allocate little don't keep much memory around. */
+    const int64_t min_chunk_size = 64 * 1024;
+    const int64_t max_chunk_size = 16 * 1024 * 1024;
+
+    this->chunk_index++;
+    if (this->chunk_index < this->chunks.size() && this->chunks[this->chunk_index].size < min_size)
+    {
+      free_chunk(this->chunks[this->chunk_index]);
+      this->chunks.remove(this->chunk_index);
+    }
+    if (this->chunk_index >= this->chunks.size() ||
+        this->chunks[this->chunk_index].size < min_size)
+    {
+      const int64_t growing_size = min_chunk_size << std::min<int64_t>(this->chunk_index, 8);
+      const int64_t size = std::max(min_size, std::min(growing_size, max_chunk_size));
+      this->chunks.insert(this->chunk_index, allocate_chunk(size));
+    }
+    const ScratchChunk &chunk = this->chunks[this->chunk_index];
+    this->current = uintptr_t(chunk.buffer);
+    this->end = this->current + uintptr_t(chunk.size);
+  }
+
+  /** Called when the outermost scope ends and all memory is unused. */
+  void reset()
+  {
+    /* Memory that every thread may keep between scopes. Only the first chunks are kept, they are
+     * small enough that idle threads don't hold on to much memory, while the memory of large
+     * scopes is given back right away. */
+    const int64_t retained_size = 1024 * 1024;
+
+    this->chunk_index = -1;
+    this->current = 0;
+    this->end = 0;
+    int64_t total_size = 0;
+    for (const int64_t i : this->chunks.index_range()) {
+      total_size += this->chunks[i].size;
+      if (total_size > retained_size) {
+        for (const ScratchChunk &chunk : this->chunks.as_span().drop_front(i)) {
+          free_chunk(chunk);
+        }
+        this->chunks.resize(i);
+        break;
+      }
+    }
+  }
+};
+
+}  // namespace
+
+static thread_local ScratchArena thread_arena;
+
+ScratchScope::ScratchScope()
+{
+  ScratchArena &arena = thread_arena;
+  chunk_index_ = arena.chunk_index;
+  position_ = arena.current;
+  arena.scopes_num++;
+}
+
+ScratchScope::~ScratchScope()
+{
+  ScratchArena &arena = thread_arena;
+  BLI_assert(arena.scopes_num > 0);
+  arena.scopes_num--;
+  if (arena.scopes_num == 0) {
+    arena.reset();
+    return;
+  }
+  arena.chunk_index = chunk_index_;
+  arena.current = position_;
+  arena.end = chunk_index_ == -1 ? 0 :
+                                   uintptr_t(arena.chunks[chunk_index_].buffer) +
+                                       uintptr_t(arena.chunks[chunk_index_].size);
+}
+
+int64_t scratch_allocator_memory_in_use()
+{
+  return chunks_size_total.load(std::memory_order_relaxed);
+}
+
+void *ScratchAllocator::allocate(const size_t size, const size_t alignment, const char *name)
+{
+  BLI_assert(is_power_of_2(int(alignment)));
+  const size_t header_alignment = std::max(alignment, alignof(ScratchHeader));
+  ScratchArena &arena = thread_arena;
+  if (arena.scopes_num > 0) {
+    return arena.allocate(int64_t(size), int64_t(header_alignment));
+  }
+  const size_t offset = std::max(header_alignment, sizeof(ScratchHeader));
+  void *buffer = MEM_mallocN_aligned(size + offset, header_alignment, name);
+  void *ptr = POINTER_OFFSET(buffer, offset);
+  ScratchHeader *header = static_cast<ScratchHeader *>(ptr) - 1;
+  header->heap_offset = int64_t(offset);
+  header->size = int64_t(size);
+  return ptr;
+}
+
+void ScratchAllocator::deallocate(void *ptr)
+{
+  const ScratchHeader *header = static_cast<const ScratchHeader *>(ptr) - 1;
+  if (header->heap_offset != 0) {
+    MEM_freeN(POINTER_OFFSET(ptr, -header->heap_offset));
+    return;
+  }
+  /* Give back the most recent allocation of the current thread, so that e.g. a container that is
+   * created and destructed in a loop doesn't use more memory in every iteration. Memory from
+   * other threads or older allocations is reclaimed when the scope ends. */
+  ScratchArena &arena = thread_arena;
+  if (arena.scopes_num == 0 || uintptr_t(ptr) + uintptr_t(header->size) != arena.current) {
+    return;
+  }
+  /* The allocation could also end exactly where the current chunk of this thread begins. */
+  if (uintptr_t(header) < uintptr_t(arena.chunks[arena.chunk_index].buffer)) {
+    return;
+  }
+  arena.current = uintptr_t(header);
+}
+
+}  // namespace blender
@@ -0,0 +1,31 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include "BLI_simd.hh"
+#include "BLI_system.h"
+
+namespace blender::simd {
+
+static CPUArch cpu_arch_detect()
+{
+  if (BLI_cpu_support_avx512()) {
+    return CPUArch::AVX512;
+  }
+  if (BLI_cpu_support_avx2()) {
+    return CPUArch::AVX2;
+  }
+  return CPUArch::Baseline;
+}
+
+CPUArch cpu_arch()
+{
+  static const CPUArch arch = cpu_arch_detect();
+  return arch;
+}
+
+}  // namespace blender::simd
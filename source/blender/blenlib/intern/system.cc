@@ -182,6 +182,71 @@ int BLI_cpu_support_sse42()
   return 0;
 }
 
+#if defined(_MSC_VER) && defined(_M_X64)
+/**
+ * Check the CPUID feature bits of leaf 7 and that the operating system saves the registers
+ * given by \a xcr0_mask on context switches. The other `x86-64-v3` extensions are always
+ * checked, since MSVC has no flag to enable AVX2 without them.
+ */
+static bool cpu_support_leaf7(const int ebx_mask, const unsigned long long xcr0_mask)
+{
+  int result[4];
+  __cpuid(result, 0);
+  if (result[0] < 7) {
+    return false;
+  }
+  __cpuid(result, 1);
+  /* OSXSAVE, AVX and FMA, as well as MOVBE and F16C which `/arch:AVX2` may use. */
+  const int leaf1_ecx_mask = (1 << 27) | (1 << 28) | (1 << 12) | (1 << 22) | (1 << 29);
+  if ((result[2] & leaf1_ecx_mask) != leaf1_ecx_mask) {
+    return false;
+  }
+  __cpuid(result, 0x80000000);
+  if (uint(result[0]) < 0x80000001u) {
+    return false;
+  }
+  __cpuid(result, 0x80000001);
+  /* LZCNT. */
+  if ((result[2] & (1 << 5)) == 0) {
+    return false;
+  }
+  if ((_xgetbv(0) & xcr0_mask) != xcr0_mask) {
+    return false;
+  }
+  __cpuidex(result, 7, 0);
+  return (result[1] & ebx_mask) == ebx_mask;
+}
+#endif
+
+int BLI_cpu_support_avx2()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  /* Also checks that the operating system supports the wider registers. */
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(_MSC_VER) && defined(_M_X64)
+  /* AVX2, BMI1 and BMI2, with SSE and AVX register state. This is the `x86-64-v3` feature set
+   * that `/arch:AVX2` may generate code for. */
+  return cpu_support_leaf7((1 << 5) | (1 << 3) | (1 << 8), 0x6);
+#else
+  return 0;
+#endif
+}
+
+int BLI_cpu_support_avx512()
+{
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  return BLI_cpu_support_avx2() && __builtin_cpu_supports("avx512f") &&
+         __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512cd") &&
+         __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl");
+#elif defined(_MSC_VER) && defined(_M_X64)
+  /* AVX-512 F, DQ, CD, BW and VL, with opmask and ZMM register state. */
+  const int ebx_mask = (1 << 16) | (1 << 17) | (1 << 28) | (1 << 30) | int(1u << 31);
+  return BLI_cpu_support_avx2() && cpu_support_leaf7(ebx_mask, 0xE6);
+#else
+  return 0;
+#endif
+}
+
 void BLI_hostname_get(char *buffer, size_t buffer_maxncpy)
 {
 #ifndef WIN32
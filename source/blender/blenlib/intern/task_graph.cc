@@ -11,6 +11,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_task.h"
+#include "BLI_task_profiler.hh"
 
 #include <memory>
 #include <vector>
@@ -46,6 +47,8 @@ struct TaskNode {
   /* Optional callback to free task data along with the graph. If task data
    * is shared between nodes, only a single task node should free the data. */
   TaskGraphNodeFreeFunction free_func;
+  /** See #threading::profiler::current_label. */
+  int profiler_label;
 
   TaskNode(TaskGraph *task_graph,
            TaskGraphNodeRunFunction run_func,
@@ -59,7 +62,9 @@ struct TaskNode {
 #endif
         run_func(run_func),
         task_data(task_data),
-        free_func(free_func)
+        free_func(free_func),
+        profiler_label(threading::profiler::is_enabled() ? threading::profiler::current_label() :
+                                                           -1)
   {
 #ifndef WITH_TBB
     UNUSED_VARS(task_graph);
@@ -79,6 +84,7 @@ struct TaskNode {
 #ifdef WITH_TBB
   tbb::flow::continue_msg run(const tbb::flow::continue_msg /*input*/)
   {
+    threading::profiler::ScopedTask task("task_graph", profiler_label);
     run_func(task_data);
     return tbb::flow::continue_msg();
   }
@@ -86,7 +92,10 @@ struct TaskNode {
 
   void run_serial()
   {
-    run_func(task_data);
+    {
+      threading::profiler::ScopedTask task("task_graph", profiler_label);
+      run_func(task_data);
+    }
     for (TaskNode *successor : successors) {
       successor->run_serial();
     }
@@ -20,6 +20,7 @@
 #include "BLI_assert.h"
 #include "BLI_mempool.h"
 #include "BLI_task.h"
+#include "BLI_task_profiler.hh"
 #include "BLI_threads.h"
 #include "BLI_vector.hh"
 
@@ -45,13 +46,21 @@ class Task {
   void *taskdata;
   bool free_taskdata;
   TaskFreeFunction freedata;
+  /** See #threading::profiler::current_label. */
+  int profiler_label;
 
   Task(TaskPool *pool,
        TaskRunFunction run,
        void *taskdata,
        bool free_taskdata,
        TaskFreeFunction freedata)
-      : pool(pool), run(run), taskdata(taskdata), free_taskdata(free_taskdata), freedata(freedata)
+      : pool(pool),
+        run(run),
+        taskdata(taskdata),
+        free_taskdata(free_taskdata),
+        freedata(freedata),
+        profiler_label(threading::profiler::is_enabled() ? threading::profiler::current_label() :
+                                                           -1)
   {
   }
 
@@ -76,7 +85,8 @@ class Task {
         run(other.run),
         taskdata(other.taskdata),
         free_taskdata(other.free_taskdata),
-        freedata(other.freedata)
+        freedata(other.freedata),
+        profiler_label(other.profiler_label)
   {
     other.pool = nullptr;
     other.run = nullptr;
@@ -96,7 +106,8 @@ class Task {
         run(other.run),
         taskdata(other.taskdata),
         free_taskdata(other.free_taskdata),
-        freedata(other.freedata)
+        freedata(other.freedata),
+        profiler_label(other.profiler_label)
   {
     ((Task &)other).pool = nullptr;
     ((Task &)other).run = nullptr;
@@ -117,6 +128,7 @@ class Task {
 /* Execute task. */
 void Task::operator()() const
 {
+  threading::profiler::ScopedTask task("task_pool", profiler_label);
   run(pool, taskdata);
 }
 
@@ -0,0 +1,241 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "BLI_fileops.hh"
+#include "BLI_mutex.hh"
+#include "BLI_task_profiler.hh"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+#include "BLI_vector_set.hh"
+
+namespace blender::threading::profiler {
+
+using Clock = std::chrono::steady_clock;
+
+namespace detail {
+std::atomic<bool> is_enabled = false;
+}
+
+namespace {
+
+struct Event {
+  /** Static string, either a task type or null for #ScopedLabel scopes. */
+  const char *name;
+  int label;
+  int64_t grain_size;
+  int64_t size;
+  Clock::time_point start;
+  Clock::time_point end;
+};
+
+/**
+ * Events recorded by a single thread. The mutex is only contended while the trace is written.
+ */
+struct ThreadEvents {
+  int thread_index;
+  bool is_main;
+  Mutex mutex;
+  Vector<Event> events;
+};
+
+struct Profiler {
+  Mutex mutex;
+  std::string filepath;
+  Clock::time_point start;
+  /** Threads are never removed, so that the thread local pointers stay valid. */
+  Vector<std::unique_ptr<ThreadEvents>> threads;
+  VectorSet<std::string> labels;
+};
+
+}  // namespace
+
+static Profiler &get_profiler()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+static thread_local int thread_label = -1;
+static thread_local ThreadEvents *thread_events = nullptr;
+
+static void record_event(const Event &event)
+{
+  if (thread_events == nullptr) {
+    Profiler &profiler = get_profiler();
+    std::lock_guard lock{profiler.mutex};
+    std::unique_ptr<ThreadEvents> events = std::make_unique<ThreadEvents>();
+    events->thread_index = int(profiler.threads.size());
+    events->is_main = BLI_thread_is_main();
+    thread_events = events.get();
+    profiler.threads.append(std::move(events));
+  }
+  std::lock_guard lock{thread_events->mutex};
+  thread_events->events.append(event);
+}
+
+void start(const StringRefNull filepath)
+{
+  Profiler &profiler = get_profiler();
+  std::lock_guard lock{profiler.mutex};
+  profiler.filepath = filepath;
+  profiler.start = Clock::now();
+  detail::is_enabled = true;
+}
+
+static void write_json_string(fmt::memory_buffer &buf, const StringRef str)
+{
+  buf.push_back('"');
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      buf.push_back('\\');
+      buf.push_back(c);
+    }
+    else if (uint8_t(c) < 0x20) {
+      fmt::format_to(fmt::appender(buf), "\\u{:04x}", int(c));
+    }
+    else {
+      buf.push_back(c);
+    }
+  }
+  buf.push_back('"');
+}
+
+void finish()
+{
+  if (!is_enabled()) {
+    return;
+  }
+  detail::is_enabled = false;
+
+  Profiler &profiler = get_profiler();
+  std::lock_guard lock{profiler.mutex};
+
+  const auto to_us = [&](const Clock::time_point time) {
+    return std::chrono::duration<double, std::micro>(time - profiler.start).count();
+  };
+
+  fmt::memory_buffer buf;
+  buf.append(StringRef("{\"traceEvents\":[\n"));
+  bool is_first = true;
+  const auto begin_event = [&]() {
+    if (!is_first) {
+      buf.append(StringRef(",\n"));
+    }
+    is_first = false;
+  };
+
+  for (const std::unique_ptr<ThreadEvents> &thread : profiler.threads) {
+    std::lock_guard thread_lock{thread->mutex};
+    begin_event();
+    fmt::format_to(fmt::appender(buf),
+                   "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},"
+                   "\"args\":{{\"name\":\"{} {}\"}}}}",
+                   thread->thread_index,
+                   thread->is_main ? "Main" : "Worker",
+                   thread->thread_index);
+
+    for (const Event &event : thread->events) {
+      begin_event();
+      const StringRef label = event.label == -1 ? StringRef() :
+                                                  StringRef(profiler.labels[event.label]);
+      buf.append(StringRef("{\"name\":"));
+      write_json_string(buf, event.name ? StringRef(event.name) : label);
+      fmt::format_to(fmt::appender(buf),
+                     ",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},"
+                     "\"dur\":{:.3f},\"args\":{{",
+                     event.name ? "task" : "scope",
+                     thread->thread_index,
+                     to_us(event.start),
+                     to_us(event.end) - to_us(event.start));
+      buf.append(StringRef("\"label\":"));
+      write_json_string(buf, label);
+      if (event.grain_size > 0) {
+        fmt::format_to(fmt::appender(buf), ",\"grain_size\":{}", event.grain_size);
+      }
+      if (event.size > 0) {
+        fmt::format_to(fmt::appender(buf), ",\"size\":{}", event.size);
+      }
+      buf.append(StringRef("}}"));
+    }
+    thread->events.clear_and_shrink();
+  }
+  buf.append(StringRef("\n]}\n"));
+
+  fstream file(profiler.filepath, std::ios::out | std::ios::binary);
+  if (!file) {
+    std::cerr << "Error: could not write task trace to '" << profiler.filepath << "'\n";
+    return;
+  }
+  file.write(buf.data(), int64_t(buf.size()));
+  std::cout << "Task trace written to '" << profiler.filepath << "'\n";
+}
+
+int current_label()
+{
+  return thread_label;
+}
+
+ScopedTask::ScopedTask(const char *name,
+                       const int label,
+                       const int64_t grain_size,
+                       const int64_t size)
+    : is_recording_(is_enabled())
+{
+  if (!is_recording_) {
+    return;
+  }
+  name_ = name;
+  label_ = label;
+  grain_size_ = grain_size;
+  size_ = size;
+  /* Nested tasks are attributed to the same label. */
+  previous_label_ = thread_label;
+  thread_label = label;
+  start_ = Clock::now();
+}
+
+ScopedTask::~ScopedTask()
+{
+  if (!is_recording_) {
+    return;
+  }
+  thread_label = previous_label_;
+  record_event({name_, label_, grain_size_, size_, start_, Clock::now()});
+}
+
+ScopedLabel::ScopedLabel(const StringRef label) : is_recording_(is_enabled())
+{
+  if (!is_recording_) {
+    return;
+  }
+  Profiler &profiler = get_profiler();
+  {
+    std::lock_guard lock{profiler.mutex};
+    label_ = int(profiler.labels.index_of_or_add_as(label));
+  }
+  previous_label_ = thread_label;
+  thread_label = label_;
+  start_ = Clock::now();
+}
+
+ScopedLabel::~ScopedLabel()
+{
+  if (!is_recording_) {
+    return;
+  }
+  thread_label = previous_label_;
+  record_event({nullptr, label_, 0, 0, start_, Clock::now()});
+}
+
+}  // namespace blender::threading::profiler
@@ -17,6 +17,7 @@
 #include "BLI_offset_indices.hh"
 #include "BLI_task.h"
 #include "BLI_task.hh"
+#include "BLI_task_profiler.hh"
 #include "BLI_threads.h"
 #include "BLI_vector.hh"
 
@@ -250,9 +251,20 @@ static void parallel_for_impl_accumulated_size_lookup(
 
 void parallel_for_impl(const IndexRange range,
                        const int64_t grain_size,
-                       const FunctionRef<void(IndexRange)> function,
+                       const FunctionRef<void(IndexRange)> user_function,
                        const TaskSizeHints &size_hints)
 {
+  FunctionRef<void(IndexRange)> function = user_function;
+  int profiler_label = -1;
+  const auto profiled_function = [&](const IndexRange sub_range) {
+    profiler::ScopedTask task("parallel_for", profiler_label, grain_size, sub_range.size());
+    user_function(sub_range);
+  };
+  if (profiler::is_enabled()) {
+    profiler_label = profiler::current_label();
+    function = profiled_function;
+  }
+
 #ifdef WITH_TBB
   lazy_threading::send_hint();
   switch (size_hints.type) {
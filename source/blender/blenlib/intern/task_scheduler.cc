@@ -10,9 +10,12 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_lazy_threading.hh"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #ifdef WITH_TBB
 /* Need to include at least one header to get the version define. */
@@ -22,6 +25,11 @@
 #    include <tbb/global_control.h>
 #    define WITH_TBB_GLOBAL_CONTROL
 #  endif
+#  if TBB_INTERFACE_VERSION_MAJOR >= 12
+#    include <tbb/info.h>
+#    include <tbb/task_group.h>
+#    define WITH_TBB_NUMA
+#  endif
 #endif
 
 namespace blender {
@@ -32,6 +40,30 @@ static int task_scheduler_num_threads = 1;
 #ifdef WITH_TBB_GLOBAL_CONTROL
 static tbb::global_control *task_scheduler_global_control = nullptr;
 #endif
+#ifdef WITH_TBB_NUMA
+/**
+ * One arena per NUMA node, with its threads pinned to that node. Only used when there is more
+ * than one node, otherwise the default arena is used for everything.
+ */
+static Vector<tbb::task_arena *> task_scheduler_numa_arenas;
+
+static void task_scheduler_numa_arenas_init(const int threads_override_num)
+{
+  const std::vector<tbb::numa_node_id> numa_nodes = tbb::info::numa_nodes();
+  const int numa_nodes_num = int(numa_nodes.size());
+  if (numa_nodes_num <= 1) {
+    return;
+  }
+  for (const tbb::numa_node_id numa_node : numa_nodes) {
+    tbb::task_arena::constraints constraints{numa_node};
+    if (threads_override_num > 0) {
+      constraints.set_max_concurrency(std::max(1, threads_override_num / numa_nodes_num));
+    }
+    /* Arenas are initialized lazily, so this doesn't create any threads yet. */
+    task_scheduler_numa_arenas.append(MEM_new<tbb::task_arena>(__func__, constraints));
+  }
+}
+#endif
 
 void BLI_task_scheduler_init()
 {
@@ -55,10 +87,20 @@ void BLI_task_scheduler_init()
 #else
   task_scheduler_num_threads = BLI_system_thread_count();
 #endif
+
+#ifdef WITH_TBB_NUMA
+  task_scheduler_numa_arenas_init(threads_override_num);
+#endif
 }
 
 void BLI_task_scheduler_exit()
 {
+#ifdef WITH_TBB_NUMA
+  for (tbb::task_arena *arena : task_scheduler_numa_arenas) {
+    MEM_delete(arena);
+  }
+  task_scheduler_numa_arenas.clear_and_shrink();
+#endif
 #ifdef WITH_TBB_GLOBAL_CONTROL
   MEM_delete(task_scheduler_global_control);
 #endif
@@ -79,4 +121,56 @@ void BLI_task_isolate(void (*func)(void *userdata), void *userdata)
 #endif
 }
 
+namespace threading {
+
+int numa_nodes_num()
+{
+#ifdef WITH_TBB_NUMA
+  return std::max<int>(1, task_scheduler_numa_arenas.size());
+#else
+  return 1;
+#endif
+}
+
+namespace detail {
+
+void parallel_for_numa_impl(const IndexRange range,
+                            const int64_t grain_size,
+                            const FunctionRef<void(IndexRange)> function)
+{
+#ifdef WITH_TBB_NUMA
+  const int64_t nodes_num = task_scheduler_numa_arenas.size();
+  if (nodes_num <= 1) {
+    parallel_for(range, grain_size, function);
+    return;
+  }
+
+  /* Make sure the lazy threading hints are send now, because they shouldn't be send out of an
+   * isolated region. */
+  lazy_threading::send_hint();
+  lazy_threading::ReceiverIsolation isolation;
+
+  /* Work is submitted to all arenas first, so that the nodes run concurrently. Waiting inside
+   * each arena lets the calling thread help with the work of that node. */
+  Array<tbb::task_group> task_groups(nodes_num);
+  for (const int64_t node : IndexRange(nodes_num)) {
+    const IndexRange node_range = IndexRange::from_begin_end(
+        range.start() + range.size() * node / nodes_num,
+        range.start() + range.size() * (node + 1) / nodes_num);
+    task_scheduler_numa_arenas[node]->execute([&, node, node_range]() {
+      task_groups[node].run(
+          [&, node_range]() { parallel_for(node_range, grain_size, function); });
+    });
+  }
+  for (const int64_t node : IndexRange(nodes_num)) {
+    task_scheduler_numa_arenas[node]->execute([&]() { task_groups[node].wait(); });
+  }
+#else
+  parallel_for(range, grain_size, function);
+#endif
+}
+
+}  // namespace detail
+}  // namespace threading
+
 }  // namespace blender
@@ -287,4 +287,21 @@ TEST(array_utils, FindAllRanges5)
   find_all_ranges_test(data, data_cmp);
 }
 
+TEST(array_utils, FillZeroNuma)
+{
+  /* Not a multiple of the page size. */
+  Array<uint8_t> data(1024 * 1024 + 3, 1);
+  array_utils::fill_zero_numa(data.data(), data.size());
+  EXPECT_TRUE(
+      std::all_of(data.begin(), data.end(), [](const uint8_t value) { return value == 0; }));
+}
+
+TEST(array_utils, UninitializedFillNuma)
+{
+  Array<std::string> data(10000, NoInitialization());
+  array_utils::uninitialized_fill_numa(data.as_mutable_span(), std::string("Value"));
+  EXPECT_TRUE(std::all_of(
+      data.begin(), data.end(), [](const std::string &value) { return value == "Value"; }));
+}
+
 }  // namespace blender
@@ -8,9 +8,12 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_compiler_attrs.h"
+#include "BLI_index_mask.hh"
 #include "BLI_kdopbvh.hh"
 #include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
 #include "BLI_rand.h"
 
 namespace blender {
@@ -137,4 +140,166 @@ TEST(kdopbvh, OptimalFindNearest_500)
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
 
+TEST(kdopbvh, RayCastBatch)
+{
+  /* A grid of boxes on the XY plane, cast rays at them along -Z, and at some from the side. */
+  const int grid_size = 16;
+  BVHTree *tree = BLI_bvhtree_new(grid_size * grid_size, 0.0, 4, 6);
+  for (int y = 0; y < grid_size; y++) {
+    for (int x = 0; x < grid_size; x++) {
+      const float co[2][3] = {{float(x), float(y), 0.0f}, {x + 0.5f, y + 0.5f, 0.5f}};
+      BLI_bvhtree_insert(tree, y * grid_size + x, co[0], 2);
+    }
+  }
+  BLI_bvhtree_balance(tree);
+
+  const int rays_num = grid_size * grid_size + grid_size;
+  Array<float3> origins(rays_num);
+  Array<float3> directions(rays_num);
+  for (int y = 0; y < grid_size; y++) {
+    for (int x = 0; x < grid_size; x++) {
+      origins[y * grid_size + x] = float3(x + 0.25f, y + 0.25f, 10.0f);
+      directions[y * grid_size + x] = float3(0.0f, 0.0f, -1.0f);
+    }
+  }
+  for (int y = 0; y < grid_size; y++) {
+    origins[grid_size * grid_size + y] = float3(-10.0f, y + 0.25f, 0.25f);
+    directions[grid_size * grid_size + y] = float3(1.0f, 0.0f, 0.0f);
+  }
+
+  BVHTreeRayHit hit_init;
+  hit_init.index = -1;
+  hit_init.dist = BVH_RAYCAST_DIST_MAX;
+  Array<BVHTreeRayHit> hits(rays_num, hit_init);
+  /* Rays 3 and 4 are masked out and should remain untouched. */
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      IndexRange(rays_num), GrainSize(64), memory, [](const int i) { return !ELEM(i, 3, 4); });
+
+  BLI_bvhtree_ray_cast_batch(*tree, mask, origins, directions, 0.0f, hits, {});
+
+  for (int y = 0; y < grid_size; y++) {
+    for (int x = 0; x < grid_size; x++) {
+      const int i = y * grid_size + x;
+      if (ELEM(i, 3, 4)) {
+        EXPECT_EQ(hits[i].index, -1);
+        continue;
+      }
+      EXPECT_EQ(hits[i].index, i);
+      EXPECT_NEAR(hits[i].dist, 9.5f, 1e-4f);
+    }
+  }
+  for (int y = 0; y < grid_size; y++) {
+    /* Side rays hit the first box of each row. */
+    const BVHTreeRayHit &hit = hits[grid_size * grid_size + y];
+    EXPECT_EQ(hit.index, y * grid_size);
+    EXPECT_NEAR(hit.dist, 10.0f, 1e-4f);
+  }
+
+  BLI_bvhtree_free(tree);
+}
+
+static void balance_sah_test(int points_len, char tree_type, int random_seed)
+{
+  RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree_median = BLI_bvhtree_new(points_len, 0.0, tree_type, 8);
+  BVHTree *tree_sah = BLI_bvhtree_new(points_len, 0.0, tree_type, 8);
+
+  /* Clustered points, where median splits are known to give poor trees. */
+  Array<float3> points(points_len);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, (i % 10 == 0) ? 100.0f : 1.0f);
+    BLI_bvhtree_insert(tree_median, i, points[i], 1);
+    BLI_bvhtree_insert(tree_sah, i, points[i], 1);
+  }
+
+  BVHTreeBuildStats stats_median;
+  BVHTreeBuildStats stats_sah;
+  BLI_bvhtree_balance_ex(tree_median, 0, &stats_median);
+  BLI_bvhtree_balance_ex(tree_sah, BVH_BALANCE_SAH, &stats_sah);
+  EXPECT_LE(stats_sah.sah_cost, stats_median.sah_cost);
+  EXPECT_GE(stats_sah.branches_num, 1);
+
+  /* Moving the points and refitting must keep working, it relies on the order of the branches. */
+  for (int i = 0; i < points_len; i++) {
+    points[i] += float3(1.0f, 2.0f, 3.0f);
+    BLI_bvhtree_update_node(tree_sah, i, points[i], nullptr, 1);
+  }
+  BLI_bvhtree_update_tree(tree_sah);
+
+  for (int i = 0; i < points_len; i++) {
+    const int j = BLI_bvhtree_find_nearest(tree_sah, points[i], nullptr, nullptr, nullptr);
+    EXPECT_GE(j, 0);
+    EXPECT_LT(j, points_len);
+    EXPECT_EQ(points[i], points[j]);
+  }
+
+  BLI_bvhtree_free(tree_median);
+  BLI_bvhtree_free(tree_sah);
+  BLI_rng_free(rng);
+}
+
+TEST(kdopbvh, BalanceSAH_Binary)
+{
+  balance_sah_test(2, 2, 1234);
+  balance_sah_test(1000, 2, 12);
+}
+TEST(kdopbvh, BalanceSAH_Quad)
+{
+  balance_sah_test(3, 4, 1234);
+  balance_sah_test(1000, 4, 12);
+}
+TEST(kdopbvh, BalanceSAH_Oct)
+{
+  balance_sah_test(1000, 8, 12);
+}
+
+static void copy_refit_test(int points_len, char tree_type, int flag, int random_seed)
+{
+  RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, tree_type, 6);
+
+  Array<float3> points(points_len);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BVHTreeBuildStats stats;
+  BLI_bvhtree_balance_ex(tree, flag, &stats);
+  EXPECT_FLOAT_EQ(BLI_bvhtree_sah_cost(*tree), stats.sah_cost);
+
+  BVHTree *tree_copy = BLI_bvhtree_copy(tree);
+  EXPECT_EQ(BLI_bvhtree_get_len(tree_copy), points_len);
+
+  /* Deform the points on the copy only, the original tree must stay valid. */
+  Array<float3> points_deformed(points_len);
+  for (int i = 0; i < points_len; i++) {
+    points_deformed[i] = points[i] * float3(2.0f, 1.0f, 0.5f) + float3(0.0f, 0.0f, 10.0f);
+  }
+  BLI_bvhtree_refit(*tree_copy, 1, [&](const int index, MutableSpan<float3> r_points) {
+    r_points[0] = points_deformed[index];
+  });
+  BLI_bvhtree_free(tree);
+
+  for (int i = 0; i < points_len; i++) {
+    const int j = BLI_bvhtree_find_nearest(
+        tree_copy, points_deformed[i], nullptr, nullptr, nullptr);
+    EXPECT_GE(j, 0);
+    EXPECT_LT(j, points_len);
+    EXPECT_EQ(points_deformed[i], points_deformed[j]);
+  }
+
+  BLI_bvhtree_free(tree_copy);
+  BLI_rng_free(rng);
+}
+
+TEST(kdopbvh, CopyRefit)
+{
+  copy_refit_test(1, 2, 0, 12);
+  copy_refit_test(1000, 2, 0, 12);
+  copy_refit_test(1000, 4, 0, 12);
+  copy_refit_test(1000, 2, BVH_BALANCE_SAH, 12);
+  copy_refit_test(1000, 8, BVH_BALANCE_SAH, 12);
+}
+
 }  // namespace blender
@@ -5,6 +5,7 @@
 #include "testing/testing.h"
 
 #include "BLI_kdtree.hh"
+#include "BLI_rand.hh"
 
 #include <cmath>
 
@@ -66,4 +67,81 @@ TEST(kdtree, Deduplicate)
   deduplicate_test();
 }
 
+static Array<float3> random_positions(const int size, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float3> positions(size);
+  for (float3 &position : positions) {
+    position = rng.get_unit_float3() * rng.get_float();
+  }
+  return positions;
+}
+
+static int find_nearest_brute_force(const Span<float3> positions,
+                                    const IndexMask &mask,
+                                    const float3 &co)
+{
+  int nearest = -1;
+  float nearest_dist_sq = FLT_MAX;
+  mask.foreach_index([&](const int i) {
+    const float dist_sq = math::distance_squared(positions[i], co);
+    if (dist_sq < nearest_dist_sq) {
+      nearest_dist_sq = dist_sq;
+      nearest = i;
+    }
+  });
+  return nearest;
+}
+
+TEST(kdtree, NewFromPositions)
+{
+  /* Large enough for sub-trees to be balanced in parallel. */
+  const Array<float3> positions = random_positions(50000, 0);
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      positions.index_range(), GrainSize(4096), memory, [](const int i) { return i % 3 != 0; });
+
+  KDTree_3d *tree = kdtree_3d_new_from_positions(positions, mask);
+  EXPECT_EQ(tree->nodes_len, mask.size());
+  EXPECT_EQ(tree->max_node_index, mask.last());
+
+  const Array<float3> queries = random_positions(1000, 1);
+  for (const float3 &co : queries) {
+    EXPECT_EQ(kdtree_3d_find_nearest(tree, co, nullptr),
+              find_nearest_brute_force(positions, mask, co));
+  }
+  kdtree_3d_free(tree);
+}
+
+TEST(kdtree, NewFromPositionsEmpty)
+{
+  KDTree_3d *tree = kdtree_3d_new_from_positions({}, IndexMask());
+  EXPECT_EQ(kdtree_3d_find_nearest(tree, float3(0.0f), nullptr), -1);
+  kdtree_3d_free(tree);
+}
+
+TEST(kdtree, FindNearestNBatch)
+{
+  const Array<float3> positions = random_positions(2000, 4);
+  KDTree_3d *tree = kdtree_3d_new_from_positions(positions, positions.index_range());
+
+  constexpr int nearest_len = 5;
+  const Array<float3> queries = random_positions(2000, 5);
+  kdtree_find_nearest_n_batch<float3>(
+      *tree,
+      queries,
+      IndexRange(3, 1000),
+      nearest_len,
+      [&](const int i, const Span<KDTreeNearest_3d> nearest) {
+        KDTreeNearest_3d expected[nearest_len];
+        const int expected_len = kdtree_3d_find_nearest_n(tree, queries[i], expected, nearest_len);
+        EXPECT_EQ(nearest.size(), expected_len);
+        for (const int j : nearest.index_range()) {
+          EXPECT_EQ(nearest[j].index, expected[j].index);
+          EXPECT_EQ(nearest[j].dist, expected[j].dist);
+        }
+      });
+  kdtree_3d_free(tree);
+}
+
 }  // namespace blender
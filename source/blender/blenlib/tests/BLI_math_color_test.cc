@@ -4,6 +4,7 @@
 
 #include "testing/testing.h"
 
+#include "BLI_index_range.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_color_blend.h"
 
@@ -142,6 +143,38 @@ TEST(math_color, srgb_to_linearrgb_v3_v3)
   }
 }
 
+TEST(math_color, srgb_linearrgb_v4_array)
+{
+  /* Odd number of pixels, to test the remainder that doesn't fill a whole vector. */
+  const float srgb[7][4] = {{0.0f, 0.0023f, 0.04f, 0.5f},
+                            {0.05f, 0.1f, 0.2f, 1.0f},
+                            {0.3f, 0.4f, 0.5f, 0.0f},
+                            {0.6f, 0.71f, 0.72f, 0.25f},
+                            {0.73f, 0.8f, 0.9f, 1.0f},
+                            {1.0f, 1.1f, 2.5f, 0.75f},
+                            {5.6f, -0.1f, 0.5f, 2.0f}};
+  float linear[7][4];
+  srgb_to_linearrgb_v4_array(linear, srgb, 7);
+  for (const int i : IndexRange(7)) {
+    float expected[3];
+    srgb_to_linearrgb_v3_v3(expected, srgb[i]);
+    /* Kernels using FMA instructions may differ in the last bits. */
+    EXPECT_V3_NEAR(linear[i], expected, 1e-6f * std::max(1.0f, expected[2]));
+    EXPECT_EQ(linear[i][3], srgb[i][3]);
+  }
+
+  /* Convert back in place. */
+  float roundtrip[7][4];
+  memcpy(roundtrip, linear, sizeof(linear));
+  linearrgb_to_srgb_v4_array(roundtrip, roundtrip, 7);
+  for (const int i : IndexRange(7)) {
+    float expected[3];
+    linearrgb_to_srgb_v3_v3(expected, linear[i]);
+    EXPECT_V3_NEAR(roundtrip[i], expected, 1e-6f * std::max(1.0f, expected[0]));
+    EXPECT_EQ(roundtrip[i][3], srgb[i][3]);
+  }
+}
+
 TEST(math_color, BlendModeConsistency_SoftLight)
 {
   float fdst[4];
@@ -0,0 +1,133 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_scratch_allocator.hh"
+#include "BLI_task.hh"
+
+namespace blender::tests {
+
+static bool is_aligned(const void *ptr, const uintptr_t alignment)
+{
+  return (uintptr_t(ptr) & (alignment - 1)) == 0;
+}
+
+TEST(scratch_allocator, WithoutScope)
+{
+  ScratchVector<int> vec;
+  for (const int i : IndexRange(1000)) {
+    vec.append(i);
+  }
+  EXPECT_EQ(vec.size(), 1000);
+  EXPECT_EQ(vec[999], 999);
+}
+
+TEST(scratch_allocator, Alignment)
+{
+  ScratchScope scope;
+  ScratchAllocator allocator;
+  for (const size_t alignment : {1, 8, 16, 64, 256}) {
+    void *ptr = allocator.allocate(3, alignment, __func__);
+    EXPECT_TRUE(is_aligned(ptr, alignment));
+    allocator.deallocate(ptr);
+  }
+}
+
+TEST(scratch_allocator, ReuseAfterScope)
+{
+  const void *first_ptr;
+  {
+    ScratchScope scope;
+    ScratchArray<float> array(1000, 1.0f);
+    first_ptr = array.data();
+  }
+  ScratchScope scope;
+  ScratchArray<float> array(1000, 2.0f);
+  EXPECT_EQ(array.data(), first_ptr);
+}
+
+TEST(scratch_allocator, NestedScopes)
+{
+  ScratchScope outer_scope;
+  ScratchVector<int, 0> outer = {1, 2, 3};
+  const void *inner_ptr;
+  {
+    ScratchScope inner_scope;
+    ScratchVector<int, 0> inner = {4, 5, 6};
+    inner_ptr = inner.data();
+  }
+  {
+    ScratchScope inner_scope;
+    ScratchVector<int, 0> inner = {7, 8, 9};
+    EXPECT_EQ(inner.data(), inner_ptr);
+  }
+  EXPECT_EQ(outer.as_span(), Span({1, 2, 3}));
+}
+
+TEST(scratch_allocator, GiveBackLastAllocation)
+{
+  ScratchScope scope;
+  ScratchAllocator allocator;
+  void *a = allocator.allocate(100, 8, __func__);
+  allocator.deallocate(a);
+  void *b = allocator.allocate(100, 8, __func__);
+  EXPECT_EQ(a, b);
+  allocator.deallocate(b);
+}
+
+TEST(scratch_allocator, LargeAllocations)
+{
+  ScratchScope scope;
+  ScratchArray<char> small(100, 'a');
+  ScratchArray<char> large(64 * 1024 * 1024, 'b');
+  ScratchArray<char> small_after(100, 'c');
+  EXPECT_EQ(small[99], 'a');
+  EXPECT_EQ(large.last(), 'b');
+  EXPECT_EQ(small_after[0], 'c');
+}
+
+TEST(scratch_allocator, FreeAfterOutermostScope)
+{
+  const int64_t size = 64 * 1024 * 1024;
+  {
+    ScratchScope scope;
+    ScratchArray<char> large(size, 'a');
+    EXPECT_GE(scratch_allocator_memory_in_use(), size);
+  }
+  EXPECT_LT(scratch_allocator_memory_in_use(), size);
+}
+
+TEST(scratch_allocator, Map)
+{
+  ScratchScope scope;
+  ScratchMap<int, int> map;
+  for (const int i : IndexRange(10000)) {
+    map.add(i, i * 2);
+  }
+  EXPECT_EQ(map.size(), 10000);
+  EXPECT_EQ(map.lookup(5000), 10000);
+}
+
+TEST(scratch_allocator, Threaded)
+{
+  std::atomic<int64_t> sum = 0;
+  threading::parallel_for(IndexRange(1000), 1, [&](const IndexRange range) {
+    ScratchScope scope;
+    for (const int64_t i : range) {
+      ScratchVector<int64_t> values;
+      for (const int64_t j : IndexRange(i)) {
+        values.append(j);
+      }
+      int64_t local_sum = 0;
+      for (const int64_t value : values) {
+        local_sum += value;
+      }
+      sum += local_sum;
+    }
+  });
+  EXPECT_EQ(sum, 1000 * 999 * 998 / 6);
+}
+
+}  // namespace blender::tests
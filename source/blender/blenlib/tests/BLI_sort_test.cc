@@ -0,0 +1,117 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <limits>
+
+#include "BLI_rand.hh"
+#include "BLI_sort.hh"
+
+namespace blender::tests {
+
+template<typename T> static Array<T> random_keys(const int64_t size, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<T> keys(size);
+  for (T &key : keys) {
+    if constexpr (std::is_floating_point_v<T>) {
+      key = T(rng.get_float() * 2000.0f - 1000.0f);
+    }
+    else {
+      key = T(int64_t(rng.get_uint32()) - (std::is_signed_v<T> ? (1 << 30) : 0));
+    }
+  }
+  return keys;
+}
+
+template<typename T> static void test_radix_sort(const int64_t size)
+{
+  Array<T> keys = random_keys<T>(size, uint32_t(size));
+  Array<T> expected = keys;
+  std::sort(expected.begin(), expected.end());
+  parallel_radix_sort(keys.as_mutable_span());
+  EXPECT_EQ(keys.as_span(), expected.as_span());
+}
+
+TEST(sort, RadixSortEmpty)
+{
+  Array<int> keys;
+  parallel_radix_sort(keys.as_mutable_span());
+  EXPECT_TRUE(keys.is_empty());
+}
+
+TEST(sort, RadixSortTypes)
+{
+  for (const int64_t size : {10, 5000, 100000}) {
+    test_radix_sort<int>(size);
+    test_radix_sort<uint32_t>(size);
+    test_radix_sort<int64_t>(size);
+    test_radix_sort<uint8_t>(size);
+    test_radix_sort<int16_t>(size);
+    test_radix_sort<float>(size);
+    test_radix_sort<double>(size);
+  }
+}
+
+TEST(sort, RadixSortSpecialFloats)
+{
+  Array<float> keys(10000, 0.0f);
+  for (const int64_t i : keys.index_range()) {
+    keys[i] = float(int(i % 7) - 3);
+  }
+  keys[10] = -0.0f;
+  keys[20] = std::numeric_limits<float>::infinity();
+  keys[30] = -std::numeric_limits<float>::infinity();
+  keys[40] = std::numeric_limits<float>::denorm_min();
+  parallel_radix_sort(keys.as_mutable_span());
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  EXPECT_EQ(keys.first(), -std::numeric_limits<float>::infinity());
+  EXPECT_EQ(keys.last(), std::numeric_limits<float>::infinity());
+}
+
+TEST(sort, RadixSortByKeyIsStable)
+{
+  for (const int64_t size : {100, 100000}) {
+    Array<int> keys(size);
+    Array<int> values(size);
+    for (const int64_t i : keys.index_range()) {
+      keys[i] = int((i * 7919) % 13) - 6;
+      values[i] = int(i);
+    }
+    parallel_radix_sort_by_key(keys.as_mutable_span(), values.as_mutable_span());
+    for (const int64_t i : keys.index_range().drop_front(1)) {
+      EXPECT_LE(keys[i - 1], keys[i]);
+      if (keys[i - 1] == keys[i]) {
+        EXPECT_LT(values[i - 1], values[i]);
+      }
+    }
+  }
+}
+
+TEST(sort, SortIndicesByKey)
+{
+  for (const int64_t size : {100, 100000}) {
+    Array<float> weights = random_keys<float>(size, 5);
+    /* Add some duplicates including negative zero. */
+    for (const int64_t i : weights.index_range().take_front(size / 10)) {
+      weights[i] = (i % 2) ? 0.0f : -0.0f;
+    }
+    Array<int> indices(size);
+    for (const int64_t i : indices.index_range()) {
+      indices[i] = int(i);
+    }
+    Array<int> expected = indices;
+    std::sort(expected.begin(), expected.end(), [&](const int a, const int b) {
+      if (weights[a] == weights[b]) {
+        return a < b;
+      }
+      return weights[a] < weights[b];
+    });
+    parallel_sort_indices_by_key(weights.as_span(), indices.as_mutable_span());
+    EXPECT_EQ(indices.as_span(), expected.as_span());
+  }
+}
+
+}  // namespace blender::tests
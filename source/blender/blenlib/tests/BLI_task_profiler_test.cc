@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_task_profiler.hh"
+#include "BLI_tempfile.h"
+
+namespace blender::threading::profiler::tests {
+
+static std::string read_trace(const char *filepath)
+{
+  size_t size;
+  char *data = static_cast<char *>(BLI_file_read_text_as_mem(filepath, 0, &size));
+  std::string trace(data, size);
+  MEM_freeN(data);
+  return trace;
+}
+
+TEST(task_profiler, Disabled)
+{
+  EXPECT_FALSE(is_enabled());
+  ScopedLabel label("Not Recorded");
+  EXPECT_EQ(current_label(), -1);
+  /* Finishing without starting doesn't do anything. */
+  finish();
+}
+
+TEST(task_profiler, ChromeTrace)
+{
+  char filepath[FILE_MAX];
+  BLI_temp_directory_path_get(filepath, sizeof(filepath));
+  BLI_path_append(filepath, sizeof(filepath), "task_profiler_test.json");
+
+  start(filepath);
+  EXPECT_TRUE(is_enabled());
+  {
+    ScopedLabel label("Test \"Label\"");
+    const int label_index = current_label();
+    EXPECT_NE(label_index, -1);
+
+    parallel_for(IndexRange(100), 1, [&](const IndexRange /*range*/) {
+      /* Tasks inherit the label of the thread that started them. */
+      EXPECT_EQ(current_label(), label_index);
+    });
+
+    TaskPool *pool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+    BLI_task_pool_push(
+        pool, [](TaskPool * /*pool*/, void * /*taskdata*/) {}, nullptr, false, nullptr);
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+  EXPECT_EQ(current_label(), -1);
+  finish();
+  EXPECT_FALSE(is_enabled());
+
+  const std::string trace = read_trace(filepath);
+  EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+  EXPECT_NE(trace.find("\"name\":\"parallel_for\""), std::string::npos);
+  EXPECT_NE(trace.find("\"grain_size\":1"), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"task_pool\""), std::string::npos);
+  EXPECT_NE(trace.find("\"label\":\"Test \\\"Label\\\"\""), std::string::npos);
+  EXPECT_NE(trace.find("\"cat\":\"scope\""), std::string::npos);
+
+  BLI_delete(filepath, false, false);
+}
+
+}  // namespace blender::threading::profiler::tests
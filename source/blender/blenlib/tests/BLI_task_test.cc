@@ -10,6 +10,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_task.h"
@@ -246,4 +247,21 @@ TEST(task, ParallelInvoke)
   EXPECT_EQ(counter, 6);
 }
 
+TEST(task, ParallelForNuma)
+{
+  EXPECT_GE(threading::numa_nodes_num(), 1);
+  Array<std::atomic<int>> counts(100000);
+  for (std::atomic<int> &count : counts) {
+    count = 0;
+  }
+  threading::parallel_for_numa(counts.index_range(), 512, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      counts[i]++;
+    }
+  });
+  for (const std::atomic<int> &count : counts) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
 }  // namespace blender
@@ -3,6 +3,9 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 #pragma once
 
+#include <optional>
+#include <string>
+
 #include "DNA_listBase.h"
 
 #include "BLI_compiler_attrs.h"
@@ -10,6 +13,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_sys_types.h"
 #include "BLI_utility_mixins.hh"
+#include "BLI_vector.hh"
 struct BlendHandle;
 namespace blender {
 
@@ -110,6 +114,8 @@ struct BlendFileReadReport {
   struct {
     double whole;
     double libraries;
+    /** Accumulated time spent in `do_versions` code, for the main file and its libraries. */
+    double versioning;
     double lib_overrides;
     double lib_overrides_resync;
     double lib_overrides_recursive_resync;
@@ -547,6 +553,31 @@ BlendThumbnail *BLO_thumbnail_from_file(const char *filepath);
  */
 short BLO_version_from_file(const char *filepath);
 
+/** A linkable ID stored in the ID index of a .blend file, see #BLO_blendfile_id_index_read. */
+struct BLOIDIndexEntry {
+  short idcode;
+  /** The ID has asset meta-data. */
+  bool is_asset;
+  /** A preview image is stored with the ID. */
+  bool has_preview;
+  /** Packed linked ID, these are not listed as linkable data-blocks. */
+  bool is_packed;
+  /** ID name without the ID code. */
+  std::string name;
+};
+
+/**
+ * Does a very light reading of given .blend file to extract the index of its linkable IDs, which
+ * is stored at the end of the file. This only needs a couple of small reads, instead of reading
+ * all block headers like #BLO_blendhandle_from_file does. Asset meta-data is not part of the
+ * index, only whether an ID is an asset.
+ *
+ * \param filepath: The path of the blend file to read the index from.
+ * \return The IDs in the order they are stored in the file, or no value when the file has no
+ * valid index (e.g. because it was written by an older Blender version or is gzip compressed).
+ */
+std::optional<Vector<BLOIDIndexEntry>> BLO_blendfile_id_index_read(const char *filepath);
+
 /**
  * Runtime structure on `ID.runtime.readfile_data` that is available during the readfile process.
  *
@@ -38,6 +38,13 @@ struct MemFileChunk {
   size_t size;
   /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
   bool is_identical;
+  /**
+   * When true, this chunk doesn't own the memory either, it shares the buffer of a chunk with the
+   * same content in the previous step, but at a different position (e.g. because some ID was
+   * duplicated). Unlike #is_identical, this does not mean that the data is unchanged compared to
+   * the previous step.
+   */
+  bool is_shared;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
    * Defined when writing the next step (i.e. last undo step has those always false). */
@@ -45,10 +52,15 @@ struct MemFileChunk {
   /** Session UID of the ID being currently written (MAIN_ID_SESSION_UID_UNSET when not writing
    * ID-related data). Used to find matching chunks in previous memundo step. */
   uint id_session_uid;
+  /** Hash of the chunk content, used to find chunks with the same content in the next step. */
+  uint64_t hash;
 };
 
 struct MemFile {
   ListBaseT<MemFileChunk> chunks;
+  /**
+   * Size in bytes of the chunk buffers owned by this memfile (i.e. not shared with other steps).
+   */
   size_t size;
   /**
    * Some data is not serialized into a new buffer because the undo-step can take ownership of it
@@ -72,6 +84,15 @@ struct MemFileWriteData {
 
   /** Maps an ID session uid to its first reference MemFileChunk, if existing. */
   Map<uint, MemFileChunk *> id_session_uid_mapping;
+  /**
+   * Maps the content hash of reference chunks to one of these chunks, used to share the memory of
+   * chunks that do not match the reference chunk at their position but still have the same
+   * content as another one.
+   */
+  Map<uint64_t, MemFileChunk *> reference_chunk_by_hash;
+  /** Size in bytes of the written chunks that share their buffer with a #MemFileChunk::is_shared
+   * chunk, for statistics. */
+  size_t shared_size;
 };
 
 struct MemFileUndoData {
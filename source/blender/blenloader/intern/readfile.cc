@@ -16,6 +16,7 @@
 #include <ctime> /* for gmtime. */
 #include <deque>
 #include <fcntl.h> /* for open flags (O_BINARY, O_RDONLY). */
+#include <memory>
 #include <queue>
 
 #ifndef WIN32
@@ -50,6 +51,7 @@
 #include "MEM_alloc_string_storage.hh"
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_endian_defines.h"
 #include "BLI_fileops.h"
 #include "BLI_ghash.h"
@@ -61,9 +63,11 @@
 #include "BLI_string_ref.hh"
 #include "BLI_string_utf8.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -259,6 +263,12 @@ struct NewAddress {
 
   /** `nr` is "user count" for data, and ID code for libdata. */
   int nr;
+
+  /**
+   * Data-block whose content has not been read yet (#newp is null then). Only used for data
+   * (#FileData.datamap), see #read_data_into_datamap.
+   */
+  BHead *bhead;
 };
 
 struct OldNewMap {
@@ -280,7 +290,20 @@ static bool oldnewmap_insert(OldNewMap *onm, const void *oldaddr, void *newaddr,
     return false;
   }
 
-  return onm->map.add_overwrite(oldaddr, NewAddress{newaddr, nr});
+  return onm->map.add_overwrite(oldaddr, NewAddress{newaddr, nr, nullptr});
+}
+
+/**
+ * Register a data-block that is only read from the file when its address is first looked up.
+ * \return `true` if no existing entry was overwritten.
+ */
+static bool oldnewmap_insert_lazy(OldNewMap *onm, const void *oldaddr, BHead *bhead)
+{
+  if (oldaddr == nullptr) {
+    return false;
+  }
+
+  return onm->map.add_overwrite(oldaddr, NewAddress{nullptr, 0, bhead});
 }
 
 static void oldnewmap_lib_insert(FileData *fd, const void *oldaddr, ID *newaddr, const int id_code)
@@ -327,9 +350,9 @@ static void *oldnewmap_liblookup(OldNewMap *onm, const void *addr, const bool is
 
 static void oldnewmap_clear(OldNewMap *onm)
 {
-  /* Free unused data. */
+  /* Free unused data. Lazily read data that was never accessed has not been allocated. */
   for (NewAddress &new_addr : onm->map.values()) {
-    if (new_addr.nr == 0) {
+    if (new_addr.nr == 0 && new_addr.newp != nullptr) {
       MEM_freeN(new_addr.newp);
     }
   }
@@ -1422,22 +1445,98 @@ short BLO_version_from_file(const char *filepath)
   return version;
 }
 
+static std::optional<Vector<BLOIDIndexEntry>> read_file_id_index(FileData *fd)
+{
+  FileReader *file = fd->file;
+  if (file->seek == nullptr) {
+    return std::nullopt;
+  }
+
+  BlendFileIDIndexTrailer trailer;
+  if (file->seek(file, -off64_t(sizeof(trailer)), SEEK_END) < 0 ||
+      file->read(file, &trailer, sizeof(trailer)) != sizeof(trailer) ||
+      memcmp(trailer.magic, BLO_ID_INDEX_MAGIC, sizeof(trailer.magic)) != 0)
+  {
+    return std::nullopt;
+  }
+  if (file->seek(file, -off64_t(sizeof(trailer) + trailer.entries_size), SEEK_END) < 0) {
+    return std::nullopt;
+  }
+  Array<uint8_t> data(trailer.entries_size);
+  if (file->read(file, data.data(), data.size()) != data.size()) {
+    return std::nullopt;
+  }
+
+  Vector<BLOIDIndexEntry> entries;
+  entries.reserve(trailer.entries_num);
+  int64_t offset = 0;
+  for ([[maybe_unused]] const int i : IndexRange(trailer.entries_num)) {
+    BlendFileIDIndexEntry entry;
+    if (offset + int64_t(sizeof(entry)) > data.size()) {
+      return std::nullopt;
+    }
+    memcpy(&entry, &data[offset], sizeof(entry));
+    offset += sizeof(entry);
+    if (offset + entry.name_len > data.size()) {
+      return std::nullopt;
+    }
+    entries.append({entry.idcode,
+                    (entry.flag & BLO_ID_INDEX_IS_ASSET) != 0,
+                    (entry.flag & BLO_ID_INDEX_HAS_PREVIEW) != 0,
+                    (entry.flag & BLO_ID_INDEX_IS_PACKED) != 0,
+                    std::string(reinterpret_cast<const char *>(&data[offset]), entry.name_len)});
+    offset += entry.name_len;
+  }
+  if (offset != data.size()) {
+    return std::nullopt;
+  }
+  return entries;
+}
+
+std::optional<Vector<BLOIDIndexEntry>> BLO_blendfile_id_index_read(const char *filepath)
+{
+  std::optional<Vector<BLOIDIndexEntry>> entries;
+  FileData *fd = blo_filedata_from_file_minimal(filepath);
+  if (fd) {
+    entries = read_file_id_index(fd);
+    blo_filedata_free(fd);
+  }
+  return entries;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
 /** \name Old/New Pointer Map
  * \{ */
 
+/* Only direct data-blocks. Reads the data-block content on first access. */
+static void *newdataadr_ex(FileData *fd, const void *adr, const bool increase_users)
+{
+  NewAddress *entry = fd->datamap->map.lookup_ptr(adr);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  if (entry->bhead != nullptr) {
+    entry->newp = read_struct(fd, entry->bhead, fd->datamap_blockname, fd->datamap_id_type_index);
+    entry->bhead = nullptr;
+  }
+  if (increase_users) {
+    entry->nr++;
+  }
+  return entry->newp;
+}
+
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  return newdataadr_ex(fd, adr, true);
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  return newdataadr_ex(fd, adr, false);
 }
 
 void *blo_read_get_new_globaldata_address(FileData *fd, const void *adr)
@@ -2742,18 +2841,28 @@ static bool direct_link_id(FileData *fd,
   return success;
 }
 
-/* Read all data associated with a datablock into datamap. */
+/**
+ * Register all data associated with a datablock into datamap.
+ *
+ * The content of the data-blocks is only read (and converted to the current DNA if needed) when
+ * their address is first looked up, see #newdataadr. Data that is never used (e.g. data written
+ * only for forward compatibility, or skipped by the `blend_read_data` callbacks) is then never
+ * read nor allocated.
+ */
 static BHead *read_data_into_datamap(FileData *fd,
                                      BHead *bhead,
                                      const char *allocname,
                                      const int id_type_index)
 {
+  BLI_assert(fd->datamap->map.is_empty());
+  fd->datamap_blockname = allocname;
+  fd->datamap_id_type_index = id_type_index;
+
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == BLO_CODE_DATA) {
-    void *data = read_struct(fd, bhead, allocname, id_type_index);
-    if (data) {
-      const bool is_new = oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+    if (bhead->len && fd->compflags[bhead->SDNAnr] != SDNA_CMP_REMOVED) {
+      const bool is_new = oldnewmap_insert_lazy(fd->datamap, bhead->old, bhead);
       if (!is_new) {
         CLOG_ERROR(&LOG,
                    "Blendfile corruption: Invalid, or multiple `bhead` with same old address "
@@ -3639,6 +3748,31 @@ static void do_versions_userdef(FileData * /*fd*/, BlendFileData *bfd)
   blo_do_versions_userdef(user);
 }
 
+/**
+ * Run a single versioning function (unless reading the file already failed), accumulating the
+ * time spent in #BlendFileReadReport.duration.versioning. Per-function timings are logged with
+ * the debug log level, which helps spotting regressions in versioning code.
+ */
+template<typename Fn>
+static void do_versions_step(FileData *fd, Main *main, const char *name, const Fn &fn)
+{
+  if (main->is_read_invalid) {
+    return;
+  }
+  const double time_start = BLI_time_now_seconds();
+  fn();
+  const double duration = BLI_time_now_seconds() - time_start;
+  fd->reports->duration.versioning += duration;
+  CLOG_DEBUG(&LOG,
+             "%s: %.3fms (%s)",
+             name,
+             duration * 1000.0,
+             main->curlib ? main->curlib->filepath : main->filepath);
+}
+
+#define DO_VERSIONS_STEP(fd, main, fn, ...) \
+  do_versions_step(fd, main, #fn, [&]() { fn(__VA_ARGS__); })
+
 static void do_versions(FileData *fd, Library *lib, Main *main)
 {
   /* WATCH IT!!!: pointers from libdata have not been converted */
@@ -3685,51 +3819,21 @@ static void do_versions(FileData *fd, Library *lib, Main *main)
               main->build_hash);
   }
 
-  if (!main->is_read_invalid) {
-    blo_do_versions_pre250(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_250(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_260(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_270(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_280(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_290(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_300(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_400(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_410(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_420(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_430(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_440(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_450(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_500(fd, lib, main);
-  }
-  if (!main->is_read_invalid) {
-    blo_do_versions_510(fd, lib, main);
-  }
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_pre250, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_250, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_260, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_270, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_280, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_290, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_300, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_400, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_410, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_420, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_430, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_440, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_450, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_500, fd, lib, main);
+  DO_VERSIONS_STEP(fd, main, blo_do_versions_510, fd, lib, main);
 
   /* WATCH IT!!!: pointers from libdata have not been converted yet here! */
   /* WATCH IT 2!: #UserDef struct init see #do_versions_userdef() above! */
@@ -3750,55 +3854,35 @@ static void do_versions_after_linking(FileData *fd, Main *main)
              main->versionfile,
              main->subversionfile);
 
+  /* All versioning after linking is gated by version checks, so there is nothing to do for
+   * files saved by the current version. */
+  if (MAIN_VERSION_FILE_ATLEAST(main, BLENDER_FILE_VERSION, BLENDER_FILE_SUBVERSION)) {
+    return;
+  }
+
   /* Don't allow versioning to create new data-blocks. */
   main->is_locked_for_linking = true;
 
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_250(main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_260(main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_270(main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_280(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_290(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_300(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_400(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_410(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_420(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_430(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_440(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_450(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_500(fd, main);
-  }
-  if (!main->is_read_invalid) {
-    do_versions_after_linking_510(fd, main);
-  }
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_250, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_260, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_270, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_280, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_290, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_300, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_400, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_410, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_420, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_430, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_440, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_450, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_500, fd, main);
+  DO_VERSIONS_STEP(fd, main, do_versions_after_linking_510, fd, main);
 
   main->is_locked_for_linking = false;
 }
 
+#undef DO_VERSIONS_STEP
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -4112,6 +4196,23 @@ static void blo_read_file_checks(Main *bmain)
   UNUSED_VARS_NDEBUG(bmain);
 }
 
+/**
+ * Whether the data read from the file of \a bmain, or from any of its libraries, was written by an
+ * older version of Blender and may need to go through #do_versions_after_linking.
+ */
+static bool main_needs_versioning_after_linking(Main *bmain)
+{
+  if (!MAIN_VERSION_FILE_ATLEAST(bmain, BLENDER_FILE_VERSION, BLENDER_FILE_SUBVERSION)) {
+    return true;
+  }
+  for (Library &lib : bmain->libraries.items_mutable()) {
+    if (!LIBRARY_VERSION_FILE_ATLEAST(&lib, BLENDER_FILE_VERSION, BLENDER_FILE_SUBVERSION)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 {
   BHead *bhead = blo_bhead_first(fd);
@@ -4379,14 +4480,19 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
       /* Note that we can't recompute user-counts at this point in undo case, we play too much with
        * IDs from different memory realms, and Main database is not in a fully valid state yet.
        */
-      /* Some versioning code does expect some proper user-reference-counting, e.g. in conversion
-       * from groups to collections... We could optimize out that first call when we are reading a
-       * current version file, but again this is really not a bottle neck currently.
-       * So not worth it. */
-      BKE_main_id_refcount_recompute(bfd->main, false);
-
-      /* Necessary to allow 2.80 layer collections conversion code to work. */
-      BKE_layer_collection_resync_allow();
+      /* Versioning after linking is gated by version checks, so when the file and all of its
+       * libraries are current, the extra user-counts and layer collections handling it requires
+       * can be skipped. */
+      const bool needs_versioning = main_needs_versioning_after_linking(bfd->main);
+
+      if (needs_versioning) {
+        /* Some versioning code does expect some proper user-reference-counting, e.g. in
+         * conversion from groups to collections. */
+        BKE_main_id_refcount_recompute(bfd->main, false);
+
+        /* Necessary to allow 2.80 layer collections conversion code to work. */
+        BKE_layer_collection_resync_allow();
+      }
 
       /* Yep, second splitting... but this is a very cheap operation, so no big deal. */
       blo_split_main(bfd->main);
@@ -4404,7 +4510,9 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
       }
       blo_join_main(bfd->main);
 
-      BKE_layer_collection_resync_forbid();
+      if (needs_versioning) {
+        BKE_layer_collection_resync_forbid();
+      }
 
       /* And we have to compute those user-reference-counts again, as `do_versions_after_linking()`
        * does not always properly handle user counts, and/or that function does not take into
@@ -5607,40 +5715,61 @@ static void read_library_clear_weak_links(FileData *basefd, Main *mainvar)
   }
 }
 
-static FileData *read_library_file_data(FileData *basefd, Main *bmain, Main *lib_bmain)
+static void read_library_file_report_open(FileData *basefd, Library *lib)
 {
-  FileData *fd = lib_bmain->curlib->runtime->filedata;
-
-  if (fd != nullptr) {
-    /* File already open. */
-    return fd;
-  }
-
-  if (lib_bmain->curlib->packedfile) {
-    /* Read packed file. */
-    const PackedFile *pf = lib_bmain->curlib->packedfile;
-
+  if (lib->packedfile) {
     BLO_reportf_wrap(basefd->reports,
                      RPT_INFO,
                      RPT_("Read packed library: '%s', parent '%s'"),
-                     lib_bmain->curlib->filepath,
-                     library_parent_filepath(lib_bmain->curlib));
-    fd = blo_filedata_from_memory(pf->data, pf->size, basefd->reports);
-
-    /* Needed for library_append and read_libraries. */
-    STRNCPY(fd->relabase, lib_bmain->curlib->runtime->filepath_abs);
+                     lib->filepath,
+                     library_parent_filepath(lib));
   }
   else {
-    /* Read file on disk. */
     BLO_reportf_wrap(basefd->reports,
                      RPT_INFO,
                      RPT_("Read library: '%s', '%s', parent '%s'"),
-                     lib_bmain->curlib->runtime->filepath_abs,
-                     lib_bmain->curlib->filepath,
-                     library_parent_filepath(lib_bmain->curlib));
-    fd = blo_filedata_from_file(lib_bmain->curlib->runtime->filepath_abs, basefd->reports);
+                     lib->runtime->filepath_abs,
+                     lib->filepath,
+                     library_parent_filepath(lib));
+  }
+}
+
+/**
+ * Open the blend-file of the given library, reading its header, block headers and DNA.
+ *
+ * \note Only accesses the given library and the new #FileData, so it can run in parallel for
+ * different libraries.
+ */
+static FileData *read_library_file_open(Library *lib, BlendFileReadReport *reports)
+{
+  FileData *fd;
+  if (lib->packedfile) {
+    /* Read packed file. */
+    const PackedFile *pf = lib->packedfile;
+    fd = blo_filedata_from_memory(pf->data, pf->size, reports);
+
+    if (fd) {
+      /* Needed for library_append and read_libraries. */
+      STRNCPY(fd->relabase, lib->runtime->filepath_abs);
+    }
   }
+  else {
+    /* Read file on disk. */
+    fd = blo_filedata_from_file(lib->runtime->filepath_abs, reports);
+  }
+  return fd;
+}
 
+/**
+ * Hook up the (possibly null) #FileData of a newly opened library with the given library Main,
+ * and handle missing libraries.
+ */
+static FileData *read_library_file_setup(FileData *basefd,
+                                         Main *bmain,
+                                         Main *lib_bmain,
+                                         FileData *fd,
+                                         const bool has_bhead_idname_map)
+{
   if (fd) {
     /* `mainptr` is sharing the same `split_mains`, so all libraries are added immediately in a
      * single vectorset. It used to be that all FileData's had their own list, but with indirectly
@@ -5663,7 +5792,9 @@ static FileData *read_library_file_data(FileData *basefd, Main *bmain, Main *lib
 
     /* subversion */
     read_file_version_and_colorspace(fd, lib_bmain);
-    read_file_bhead_idname_map_create(fd);
+    if (!has_bhead_idname_map) {
+      read_file_bhead_idname_map_create(fd);
+    }
   }
   else {
     lib_bmain->curlib->runtime->filedata = nullptr;
@@ -5686,11 +5817,122 @@ static FileData *read_library_file_data(FileData *basefd, Main *bmain, Main *lib
   return fd;
 }
 
+/** Result of opening a library file ahead of time, see #read_libraries_open_files. */
+struct LibraryFileOpenData {
+  FileData *fd = nullptr;
+  /** Reports generated while opening the file, moved to the main reports once it is used. */
+  ReportList reports;
+  BlendFileReadReport read_report;
+};
+
+using LibraryFileOpenMap = Map<Main *, std::unique_ptr<LibraryFileOpenData>>;
+
+/**
+ * Open the files of all libraries from the \a start index on that still need to be read, in
+ * parallel. Reading the header, block headers and DNA of a library does not depend on any other
+ * library, and can take a significant amount of time for many (or remote) library files.
+ *
+ * Everything that affects shared data is left to #read_library_file_data, which is still called
+ * in the same order as before, so reports and the resulting Main do not depend on threading.
+ */
+static void read_libraries_open_files(FileData *basefd,
+                                      const int start,
+                                      LibraryFileOpenMap &open_data_map)
+{
+  Main *bmain = basefd->bmain;
+  Vector<Main *> lib_mains;
+  for (Main *libmain : bmain->split_mains->as_span().drop_front(start)) {
+    if (libmain->curlib->flag & LIBRARY_FLAG_IS_ARCHIVE) {
+      continue;
+    }
+    if (libmain->curlib->runtime->filedata != nullptr || open_data_map.contains(libmain)) {
+      continue;
+    }
+    if (has_linked_ids_to_read(libmain)) {
+      lib_mains.append(libmain);
+    }
+  }
+  if (lib_mains.size() < 2) {
+    /* Nothing to gain from threading, let #read_library_file_data open the file directly. */
+    return;
+  }
+
+  const ReportList *base_reports = basefd->reports->reports;
+  Array<LibraryFileOpenData *> open_datas(lib_mains.size());
+  for (const int i : lib_mains.index_range()) {
+    std::unique_ptr<LibraryFileOpenData> open_data = std::make_unique<LibraryFileOpenData>();
+    if (base_reports) {
+      BKE_reports_init(&open_data->reports, base_reports->flag);
+      open_data->reports.storelevel = base_reports->storelevel;
+      open_data->reports.printlevel = base_reports->printlevel;
+      open_data->read_report.reports = &open_data->reports;
+    }
+    open_datas[i] = open_data.get();
+    open_data_map.add_new(lib_mains[i], std::move(open_data));
+  }
+
+  threading::parallel_for(lib_mains.index_range(), 1, [&](const IndexRange range) {
+    for (const int i : range) {
+      LibraryFileOpenData &open_data = *open_datas[i];
+      FileData *fd = read_library_file_open(lib_mains[i]->curlib, &open_data.read_report);
+      if (fd) {
+        read_file_bhead_idname_map_create(fd);
+        /* The allocation name storage is thread local, the thread reading the data-blocks later
+         * has to use its own. */
+        fd->storage_handle = nullptr;
+      }
+      open_data.fd = fd;
+    }
+  });
+}
+
+static void read_libraries_open_files_free(LibraryFileOpenMap &open_data_map)
+{
+  for (std::unique_ptr<LibraryFileOpenData> &open_data : open_data_map.values()) {
+    if (open_data->fd) {
+      blo_filedata_free(open_data->fd);
+    }
+    if (open_data->read_report.reports) {
+      BKE_reports_free(&open_data->reports);
+    }
+  }
+  open_data_map.clear();
+}
+
+static FileData *read_library_file_data(FileData *basefd,
+                                        Main *bmain,
+                                        Main *lib_bmain,
+                                        LibraryFileOpenMap &open_data_map)
+{
+  FileData *fd = lib_bmain->curlib->runtime->filedata;
+
+  if (fd != nullptr) {
+    /* File already open. */
+    return fd;
+  }
+
+  read_library_file_report_open(basefd, lib_bmain->curlib);
+
+  std::unique_ptr<LibraryFileOpenData> open_data = open_data_map.pop_default(lib_bmain, nullptr);
+  if (open_data) {
+    /* File already opened by #read_libraries_open_files. */
+    if (open_data->read_report.reports) {
+      BKE_reports_move_to_reports(basefd->reports->reports, &open_data->reports);
+      BKE_reports_free(&open_data->reports);
+    }
+    return read_library_file_setup(basefd, bmain, lib_bmain, open_data->fd, true);
+  }
+
+  fd = read_library_file_open(lib_bmain->curlib, basefd->reports);
+  return read_library_file_setup(basefd, bmain, lib_bmain, fd, false);
+}
+
 static void read_libraries(FileData *basefd)
 {
   Main *bmain = basefd->bmain;
   BLI_assert(bmain->split_mains);
   bool do_it = true;
+  LibraryFileOpenMap open_data_map;
 
   /* At this point the base blend file has been read, and each library blend
    * encountered so far has a main with placeholders for linked data-blocks.
@@ -5720,8 +5962,12 @@ static void read_libraries(FileData *basefd)
                    libmain->curlib->id.name,
                    libmain->curlib->filepath);
 
-        /* Open file if it has not been done yet. */
-        FileData *fd = read_library_file_data(basefd, bmain, libmain);
+        /* Open file if it has not been done yet. All other libraries that are not open yet,
+         * including ones found while expanding the previous libraries, are opened at once. */
+        if (libmain->curlib->runtime->filedata == nullptr && !open_data_map.contains(libmain)) {
+          read_libraries_open_files(basefd, i, open_data_map);
+        }
+        FileData *fd = read_library_file_data(basefd, bmain, libmain, open_data_map);
 
         if (fd) {
           do_it = true;
@@ -5740,6 +5986,10 @@ static void read_libraries(FileData *basefd)
         expand_main(fd, libmain, expand_doit_library);
       }
     }
+
+    /* Should not happen, but don't leak files opened for libraries that turned out to have
+     * nothing to read. */
+    read_libraries_open_files_free(open_data_map);
   }
 
   for (Main *libmain : bmain->split_mains->as_span().drop_front(1)) {
@@ -68,6 +68,35 @@ enum eFileDataFlag {
 };
 ENUM_OPERATORS(eFileDataFlag)
 
+/**
+ * ID index, written after the #BLO_CODE_ENDB block so that it is ignored by regular file reading
+ * (including in older Blender versions). It lists the linkable IDs of the file, to allow browsing
+ * its content without parsing all of its blocks, see #BLO_blendfile_id_index_read.
+ *
+ * Layout: one #BlendFileIDIndexEntry per ID, each followed by the ID name (without ID code and
+ * null terminator), and finally the #BlendFileIDIndexTrailer at the very end of the file.
+ */
+#define BLO_ID_INDEX_MAGIC "BLIDXv01"
+
+enum {
+  BLO_ID_INDEX_IS_ASSET = 1 << 0,
+  BLO_ID_INDEX_HAS_PREVIEW = 1 << 1,
+  BLO_ID_INDEX_IS_PACKED = 1 << 2,
+};
+
+struct BlendFileIDIndexEntry {
+  int16_t idcode;
+  uint8_t flag;
+  uint8_t name_len;
+};
+
+struct BlendFileIDIndexTrailer {
+  uint32_t entries_num;
+  /** Size of all entries and their names, in bytes. */
+  uint32_t entries_size;
+  char magic[8];
+};
+
 /* Disallow since it's 32bit on ms-windows. */
 #ifdef __GNUC__
 #  pragma GCC poison off_t
@@ -142,6 +171,12 @@ struct FileData {
   int id_tag_extra = 0;
 
   OldNewMap *datamap = nullptr;
+  /**
+   * Allocation info for the data-blocks of #datamap that are only read on first access, see
+   * #read_data_into_datamap.
+   */
+  const char *datamap_blockname = nullptr;
+  int datamap_id_type_index = 0;
   OldNewMap *globmap = nullptr;
   /** Used to keep track of already loaded packed IDs to avoid loading them multiple times. */
   std::shared_ptr<Map<IDHash, ID *>> id_by_deep_hash;
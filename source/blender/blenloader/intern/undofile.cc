@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <xxhash.h>
 
 /* open/close */
 #ifndef _WIN32
@@ -43,7 +44,7 @@ namespace blender {
 void BLO_memfile_free(MemFile *memfile)
 {
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
+    if (chunk->is_identical == false && chunk->is_shared == false) {
       MEM_freeN(chunk->buf);
     }
     MEM_freeN(chunk);
@@ -67,9 +68,10 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
    * by it (i.e. shared with some previous memory steps). */
   Map<const char *, MemFileChunk *> buffer_to_second_memchunk;
 
-  /* First, detect all memchunks in second memfile that are not owned by it. */
+  /* First, detect all memchunks in second memfile that are not owned by it. Several chunks may
+   * share the same buffer, only one of them takes ownership. */
   for (MemFileChunk &sc : second->chunks) {
-    if (sc.is_identical) {
+    if (sc.is_identical || sc.is_shared) {
       buffer_to_second_memchunk.add(sc.buf, &sc);
     }
   }
@@ -77,10 +79,11 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
   /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
    * it is also used by the second memfile, transfer the ownership. */
   for (MemFileChunk &fc : first->chunks) {
-    if (!fc.is_identical) {
+    if (!fc.is_identical && !fc.is_shared) {
       if (MemFileChunk *sc = buffer_to_second_memchunk.lookup_default(fc.buf, nullptr)) {
-        BLI_assert(sc->is_identical);
+        BLI_assert(sc->is_identical || sc->is_shared);
         sc->is_identical = false;
+        sc->is_shared = false;
         fc.is_identical = true;
       }
       /* Note that if the second memfile does not use that chunk, we assume that the first one
@@ -129,13 +132,16 @@ void BLO_memfile_write_init(WriteData *wd,
         current_session_uid = mem_chunk.id_session_uid;
         mem_data->id_session_uid_mapping.add_new(current_session_uid, &mem_chunk);
       }
+      mem_data->reference_chunk_by_hash.add(mem_chunk.hash, &mem_chunk);
     }
   }
+  mem_data->shared_size = 0;
 }
 
 void BLO_memfile_write_finalize(WriteData *wd, MemFileWriteData *mem_data)
 {
   mem_data->id_session_uid_mapping.clear();
+  mem_data->reference_chunk_by_hash.clear();
   /* Move current stable pointers data from the WriteData to the written MemFile. */
   mem_data->written_memfile->stable_address_ids = MEM_new<WriteDataStableAddressIDs>(
       __func__, std::move(wd->stable_address_ids));
@@ -150,6 +156,7 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   curchunk->size = size;
   curchunk->buf = nullptr;
   curchunk->is_identical = false;
+  curchunk->is_shared = false;
   /* This is unsafe in the sense that an app handler or other code that does not
    * perform an undo push may make changes after the last undo push that
    * will then not be undo. Though it's not entirely clear that is wrong behavior. */
@@ -163,6 +170,7 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
     if (compchunk->size == curchunk->size) {
       if (memcmp(compchunk->buf, buf, size) == 0) {
         curchunk->buf = compchunk->buf;
+        curchunk->hash = compchunk->hash;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
       }
@@ -170,8 +178,27 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
     *compchunk_step = static_cast<MemFileChunk *>(compchunk->next);
   }
 
+  if (curchunk->buf != nullptr) {
+    return;
+  }
+
+  /* Not equal to the chunk at the same position, but the same content may still exist somewhere
+   * else in the reference step, e.g. when an ID was duplicated or data moved between IDs. Share
+   * its memory in that case, without considering the data unchanged. */
+  curchunk->hash = XXH3_64bits(buf, size);
+  if (const MemFileChunk *hashchunk = mem_data->reference_chunk_by_hash.lookup_default(
+          curchunk->hash, nullptr))
+  {
+    if (hashchunk->size == size && memcmp(hashchunk->buf, buf, size) == 0) {
+      curchunk->buf = hashchunk->buf;
+      curchunk->is_shared = true;
+      mem_data->shared_size += size;
+      return;
+    }
+  }
+
   /* not equal... */
-  if (curchunk->buf == nullptr) {
+  {
     char *buf_new = MEM_malloc_arrayN<char>(size, "Chunk buffer");
     memcpy(buf_new, buf, size);
     curchunk->buf = buf_new;
@@ -1740,6 +1740,10 @@ void blo_do_versions_userdef(UserDef *userdef)
     userdef->flag |= USER_HIDE_DOT_DATABLOCK;
   }
 
+  if (!USER_VERSION_ATLEAST(501, 21)) {
+    userdef->file_compression_level = 3;
+  }
+
   /**
    * Always bump subversion in BKE_blender_version.h when adding versioning
    * code here, and wrap it inside a USER_VERSION_ATLEAST check.
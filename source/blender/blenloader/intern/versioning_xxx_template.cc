@@ -44,6 +44,9 @@ void do_versions_after_linking_xxx(FileData * /*fd*/, Main * /*bmain*/)
    * Always bump subversion in BKE_blender_version.h when adding versioning
    * code here, and wrap it inside a MAIN_VERSION_FILE_ATLEAST check.
    *
+   * \note Code here must never run unconditionally: #do_versions_after_linking is skipped entirely
+   * for files saved with the current version.
+   *
    * \note Keep this message at the bottom of the function.
    */
 }
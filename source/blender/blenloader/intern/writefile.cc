@@ -57,6 +57,8 @@
  * - write #BLO_CODE_USER (#UserDef struct) for file paths:
  *   - #BLENDER_STARTUP_FILE (on UNIX `~/.config/blender/X.X/config/startup.blend`).
  *   - #BLENDER_USERPREF_FILE (on UNIX `~/.config/blender/X.X/config/userpref.blend`).
+ * - write #BLO_CODE_ENDB (end of the blocks).
+ * - write the index of linkable IDs (see #BlendFileIDIndexTrailer).
  */
 
 #include <cerrno>
@@ -163,6 +165,7 @@ namespace blender {
 #define ZSTD_BUFFER_SIZE (1 << 21) /* 2mb */
 #define ZSTD_CHUNK_SIZE (1 << 20)  /* 1mb */
 
+/** Used when the compression level from the preferences is not valid. */
 #define ZSTD_COMPRESSION_LEVEL 3
 
 static CLG_LogRef LOG = {"blend.writefile"};
@@ -230,6 +233,7 @@ class ZstdWriteWrap : public WriteWrap {
   struct ZstdWriteBlockTask;
 
   WriteWrap &base_wrap;
+  int compression_level;
 
   ListBaseT<ThreadSlot> threadpool = {};
   ListBaseT<ZstdWriteBlockTask> tasks = {};
@@ -242,8 +246,13 @@ class ZstdWriteWrap : public WriteWrap {
 
   bool write_error = false;
 
+  double timestamp_init = 0.0;
+
  public:
-  ZstdWriteWrap(WriteWrap &base_wrap) : base_wrap(base_wrap) {}
+  ZstdWriteWrap(WriteWrap &base_wrap, const int compression_level)
+      : base_wrap(base_wrap), compression_level(compression_level)
+  {
+  }
 
   bool open(const char *filepath) override;
   bool close() override;
@@ -253,6 +262,7 @@ class ZstdWriteWrap : public WriteWrap {
   void write_task(ZstdWriteBlockTask *task);
   void write_u32_le(uint32_t val);
   void write_seekable_frames();
+  void log_stats();
 };
 
 struct ZstdWriteWrap::ZstdWriteBlockTask {
@@ -275,7 +285,7 @@ void ZstdWriteWrap::write_task(ZstdWriteBlockTask *task)
   size_t out_buf_len = ZSTD_compressBound(task->size);
   void *out_buf = MEM_mallocN(out_buf_len, "Zstd out buffer");
   size_t out_size = ZSTD_compress(
-      out_buf, out_buf_len, task->data, task->size, ZSTD_COMPRESSION_LEVEL);
+      out_buf, out_buf_len, task->data, task->size, compression_level);
 
   MEM_freeN(task->data);
 
@@ -320,6 +330,8 @@ bool ZstdWriteWrap::open(const char *filepath)
   BLI_mutex_init(&mutex);
   BLI_condition_init(&condition);
 
+  timestamp_init = BLI_time_now_seconds();
+
   return true;
 }
 
@@ -364,6 +376,25 @@ void ZstdWriteWrap::write_seekable_frames()
   write_u32_le(0x8F92EAB1);
 }
 
+void ZstdWriteWrap::log_stats()
+{
+  uint64_t uncompressed_size = 0;
+  uint64_t compressed_size = 0;
+  for (const ZstdFrame &frame : frames) {
+    uncompressed_size += frame.uncompressed_size;
+    compressed_size += frame.compressed_size;
+  }
+  CLOG_INFO(&LOG,
+            "Compressed %.2f MB to %.2f MB (ratio %.2f) in %d frames with level %d, "
+            "in %.3f seconds",
+            double(uncompressed_size) / (1024.0 * 1024.0),
+            double(compressed_size) / (1024.0 * 1024.0),
+            compressed_size ? double(uncompressed_size) / double(compressed_size) : 0.0,
+            BLI_listbase_count(&frames),
+            compression_level,
+            BLI_time_now_seconds() - timestamp_init);
+}
+
 bool ZstdWriteWrap::close()
 {
   BLI_threadpool_end(&threadpool);
@@ -373,6 +404,7 @@ bool ZstdWriteWrap::close()
   BLI_condition_end(&condition);
 
   write_seekable_frames();
+  log_stats();
   BLI_freelistN(&frames);
 
   return base_wrap.close() && !write_error;
@@ -586,8 +618,11 @@ static bool mywrite_end(WriteData *wd)
   if (wd->use_memfile) {
     BLO_memfile_write_finalize(wd, &wd->mem);
     CLOG_INFO(&LOG_UNDO,
-              "Memfile undo step written in %.3f seconds",
-              BLI_time_now_seconds() - wd->timestamp_init);
+              "Memfile undo step written in %.3f seconds, %zu bytes of new data (%zu bytes shared "
+              "with moved or duplicated data)",
+              BLI_time_now_seconds() - wd->timestamp_init,
+              wd->mem.written_memfile->size,
+              wd->mem.shared_size);
   }
   else {
     CLOG_INFO(
@@ -871,6 +906,10 @@ static void writestruct_at_address_nr(WriteData *wd,
     return;
   }
 
+  if (wd->is_writing_id && struct_nr == dna::sdna_struct_id_get<PreviewImage>()) {
+    wd->id_index.id_has_preview = true;
+  }
+
   const int64_t len_in_bytes = nr * DNA_struct_size(wd->sdna, struct_nr);
   if (!SYSTEM_SUPPORTS_WRITING_FILE_VERSION_1 ||
       USER_DEVELOPER_TOOL_TEST(&U, write_legacy_blend_file_format))
@@ -1235,6 +1274,57 @@ static void write_userdef(BlendWriter *writer, const UserDef *userdef)
   }
 }
 
+/** Add the ID that has just been written to the index of the file, see #write_id_index. */
+static void write_id_index_add(WriteData *wd, const ID *id)
+{
+  const short idcode = GS(id->name);
+  if (!BKE_idtype_idcode_is_linkable(idcode)) {
+    return;
+  }
+  const char *name = id->name + 2;
+  const size_t name_len = strlen(name);
+  if (name_len == 0 || name_len > UINT8_MAX) {
+    return;
+  }
+
+  BlendFileIDIndexEntry entry{};
+  entry.idcode = idcode;
+  entry.name_len = uint8_t(name_len);
+  if (id->asset_data) {
+    entry.flag |= BLO_ID_INDEX_IS_ASSET;
+  }
+  if (wd->id_index.id_has_preview) {
+    entry.flag |= BLO_ID_INDEX_HAS_PREVIEW;
+  }
+  if (ID_IS_PACKED(id)) {
+    entry.flag |= BLO_ID_INDEX_IS_PACKED;
+  }
+  wd->id_index.data.extend(Span(reinterpret_cast<const uint8_t *>(&entry), sizeof(entry)));
+  wd->id_index.data.extend(Span(reinterpret_cast<const uint8_t *>(name), name_len));
+  wd->id_index.entries_num++;
+}
+
+/**
+ * Write the index of linkable IDs after the end of the file, where regular file reading does not
+ * see it. Allows listing the content of the file without reading all of its blocks, see
+ * #BLO_blendfile_id_index_read.
+ */
+static void write_id_index(WriteData *wd)
+{
+  if (wd->id_index.data.size() > UINT32_MAX) {
+    return;
+  }
+  BlendFileIDIndexTrailer trailer{};
+  trailer.entries_num = wd->id_index.entries_num;
+  trailer.entries_size = uint32_t(wd->id_index.data.size());
+  memcpy(trailer.magic, BLO_ID_INDEX_MAGIC, sizeof(trailer.magic));
+
+  if (!wd->id_index.data.is_empty()) {
+    mywrite(wd, wd->id_index.data.data(), size_t(wd->id_index.data.size()));
+  }
+  mywrite(wd, &trailer, sizeof(trailer));
+}
+
 /**
  * Writes ID and all its direct data to the file.
  */
@@ -1242,11 +1332,15 @@ static void write_id(WriteData *wd, ID *id)
 {
   const IDTypeInfo *id_type = BKE_idtype_get_info_from_id(id);
   mywrite_id_begin(wd, id);
+  wd->id_index.id_has_preview = false;
   if (id_type->blend_write != nullptr) {
     BlendWriter writer = {wd};
     BLO_Write_IDBuffer id_buffer{*id, wd->use_memfile, false};
     id_type->blend_write(&writer, id_buffer.get(), id);
   }
+  if (!wd->use_memfile) {
+    write_id_index_add(wd, id);
+  }
   mywrite_id_end(wd, id);
 }
 
@@ -1857,6 +1951,10 @@ static bool write_file_handle(Main *mainvar,
   bhead.code = BLO_CODE_ENDB;
   write_bhead(wd, bhead);
 
+  if (!is_undo) {
+    write_id_index(wd);
+  }
+
   return mywrite_end(wd);
 }
 
@@ -2131,7 +2229,10 @@ bool BLO_write_file(Main *mainvar,
   RawWriteWrap raw_wrap;
 
   if (write_flags & G_FILE_COMPRESS) {
-    ZstdWriteWrap zstd_wrap(raw_wrap);
+    const int compression_level = IN_RANGE_INCL(U.file_compression_level, 1, ZSTD_maxCLevel()) ?
+                                      U.file_compression_level :
+                                      ZSTD_COMPRESSION_LEVEL;
+    ZstdWriteWrap zstd_wrap(raw_wrap, compression_level);
     return BLO_write_file_impl(mainvar, filepath, write_flags, params, reports, zstd_wrap);
   }
 
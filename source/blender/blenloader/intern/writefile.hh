@@ -16,6 +16,7 @@
 
 #include "BLI_map.hh"
 #include "BLI_set.hh"
+#include "BLI_vector.hh"
 
 #include "BLO_undofile.hh"
 
@@ -121,6 +122,18 @@ struct WriteData {
   /** When true, write to #WriteData.current, could also call 'is_undo'. */
   bool use_memfile;
 
+  /**
+   * Index of the linkable IDs written to the file, stored after its end, see
+   * #BlendFileIDIndexTrailer. Not used for undo.
+   */
+  struct {
+    /** #BlendFileIDIndexEntry items followed by their names. */
+    Vector<uint8_t> data;
+    uint32_t entries_num = 0;
+    /** Whether a #PreviewImage has been written for the ID currently being written. */
+    bool id_has_preview = false;
+  } id_index;
+
   /**
    * Wrap writing, so we can use ZSTD or
    * other compression types later, see: #G_FILE_COMPRESS.
@@ -0,0 +1,162 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+#include "blendfile_loading_base_test.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_appdir.hh"
+#include "BKE_main.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_linklist.h"
+#include "BLI_path_utils.hh"
+#include "BLI_vector.hh"
+
+#include "BLO_readfile.hh"
+#include "BLO_writefile.hh"
+
+#include "DNA_ID_enums.h"
+
+namespace blender {
+
+class BlendfileIDIndexTest : public BlendfileLoadingBaseTest {
+ protected:
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    BKE_tempdir_init(nullptr);
+  }
+
+  void TearDown() override
+  {
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_tempdir_session_purge();
+  }
+
+  std::string get_temp_filepath(const char *filename)
+  {
+    return std::string(BKE_tempdir_session()) + SEP_STR + filename;
+  }
+
+  /* Saves the loaded file uncompressed, the ID index can't be read from compressed files. */
+  std::string write_loaded_file(const char *filename)
+  {
+    const std::string filepath = get_temp_filepath(filename);
+    BlendFileWriteParams params{};
+    params.remap_mode = BLO_WRITE_PATH_REMAP_NONE;
+    EXPECT_TRUE(BLO_write_file(bfile->main, filepath.c_str(), 0, &params, nullptr));
+    return filepath;
+  }
+};
+
+/* Sorted names of the IDs of the given type, as listed by reading all block headers. */
+static Vector<std::string> blendhandle_datablock_names(const std::string &filepath,
+                                                       const short idcode)
+{
+  Vector<std::string> names;
+  BlendFileReadReport bf_reports = {};
+  BlendHandle *bh = BLO_blendhandle_from_file(filepath.c_str(), &bf_reports);
+  if (bh == nullptr) {
+    ADD_FAILURE() << "Unable to open '" << filepath << "'";
+    return names;
+  }
+  int names_num = 0;
+  LinkNode *names_list = BLO_blendhandle_get_datablock_names(bh, idcode, false, &names_num);
+  for (LinkNode *link = names_list; link; link = link->next) {
+    names.append(static_cast<const char *>(link->link));
+  }
+  BLI_linklist_freeN(names_list);
+  BLO_blendhandle_close(bh);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+/* Sorted names of the IDs of the given type in the ID index. */
+static Vector<std::string> id_index_names(const Span<BLOIDIndexEntry> id_index, const short idcode)
+{
+  Vector<std::string> names;
+  for (const BLOIDIndexEntry &entry : id_index) {
+    if (entry.idcode == idcode) {
+      names.append(entry.name);
+    }
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+static void file_write_truncated(const std::string &src_filepath,
+                                 const std::string &dst_filepath,
+                                 const size_t size)
+{
+  size_t data_size = 0;
+  void *data = BLI_file_read_binary_as_mem(src_filepath.c_str(), 0, &data_size);
+  ASSERT_NE(data, nullptr);
+  ASSERT_LE(size, data_size);
+  FILE *file = BLI_fopen(dst_filepath.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  EXPECT_EQ(fwrite(data, 1, size, file), size);
+  fclose(file);
+  MEM_freeN(data);
+}
+
+TEST_F(BlendfileIDIndexTest, RoundTrip)
+{
+  if (!blendfile_load("modifier_stack" SEP_STR "array_test.blend")) {
+    return;
+  }
+  const std::string filepath = write_loaded_file("id_index_round_trip.blend");
+
+  const std::optional<Vector<BLOIDIndexEntry>> id_index = BLO_blendfile_id_index_read(
+      filepath.c_str());
+  ASSERT_TRUE(id_index.has_value());
+  ASSERT_FALSE(id_index->is_empty());
+  for (const BLOIDIndexEntry &entry : *id_index) {
+    EXPECT_FALSE(entry.name.empty());
+  }
+
+  /* The index lists the same IDs as reading all block headers, which still works with the index
+   * at the end of the file. */
+  for (const short idcode : {ID_OB, ID_ME, ID_MA, ID_SCE}) {
+    const Vector<std::string> names = blendhandle_datablock_names(filepath, idcode);
+    EXPECT_EQ(id_index_names(*id_index, idcode), names);
+  }
+  EXPECT_FALSE(id_index_names(*id_index, ID_OB).is_empty());
+}
+
+TEST_F(BlendfileIDIndexTest, TruncatedTrailer)
+{
+  if (!blendfile_load("modifier_stack" SEP_STR "array_test.blend")) {
+    return;
+  }
+  const std::string filepath = write_loaded_file("id_index_complete.blend");
+  const std::string truncated_filepath = get_temp_filepath("id_index_truncated.blend");
+  const size_t file_size = BLI_file_size(filepath.c_str());
+
+  /* Without the end of the trailer, the file has no valid index anymore. */
+  file_write_truncated(filepath, truncated_filepath, file_size - 4);
+  EXPECT_FALSE(BLO_blendfile_id_index_read(truncated_filepath.c_str()).has_value());
+}
+
+TEST_F(BlendfileIDIndexTest, NoTrailerFallback)
+{
+  const std::string &test_assets_dir = tests::flags_test_asset_dir();
+  if (test_assets_dir.empty()) {
+    return;
+  }
+  /* Files written by older versions have no index, their content has to be listed by reading all
+   * block headers. */
+  char filepath[FILE_MAX];
+  BLI_path_join(filepath,
+                sizeof(filepath),
+                test_assets_dir.c_str(),
+                "modifier_stack" SEP_STR "array_test.blend");
+  EXPECT_FALSE(BLO_blendfile_id_index_read(filepath).has_value());
+  EXPECT_FALSE(blendhandle_datablock_names(filepath, ID_OB).is_empty());
+}
+
+}  // namespace blender
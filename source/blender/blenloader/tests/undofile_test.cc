@@ -0,0 +1,83 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <string>
+
+#include "BLI_listbase.h"
+
+#include "BLO_undofile.hh"
+
+#include "intern/writefile.hh"
+
+namespace blender::tests {
+
+/* Write a memfile with one chunk per string, like undo steps do. */
+static void memfile_write(MemFile &memfile,
+                          MemFile *reference_memfile,
+                          const Span<std::string> chunks,
+                          size_t *r_shared_size = nullptr)
+{
+  WriteData wd{};
+  BLO_memfile_write_init(&wd, &wd.mem, &memfile, reference_memfile);
+  for (const std::string &chunk : chunks) {
+    BLO_memfile_chunk_add(&wd.mem, chunk.data(), chunk.size());
+  }
+  if (r_shared_size) {
+    *r_shared_size = wd.mem.shared_size;
+  }
+  BLO_memfile_write_finalize(&wd, &wd.mem);
+}
+
+static const MemFileChunk &memfile_chunk(const MemFile &memfile, const int index)
+{
+  return *static_cast<const MemFileChunk *>(BLI_findlink(&memfile.chunks, index));
+}
+
+TEST(undofile, chunk_reuse)
+{
+  const std::string a(100, 'a');
+  const std::string b(100, 'b');
+  const std::string c(100, 'c');
+  const std::string d(100, 'd');
+
+  MemFile step1{};
+  memfile_write(step1, nullptr, {a, b, c});
+  EXPECT_EQ(step1.size, a.size() * 3);
+
+  /* The first chunk is unchanged, the second has the content of the third chunk of the previous
+   * step (e.g. because an ID was duplicated) and the third is new. */
+  MemFile step2{};
+  size_t shared_size = 0;
+  memfile_write(step2, &step1, {a, c, d}, &shared_size);
+  EXPECT_EQ(step2.size, d.size());
+  EXPECT_EQ(shared_size, c.size());
+
+  const MemFileChunk &identical = memfile_chunk(step2, 0);
+  EXPECT_TRUE(identical.is_identical);
+  EXPECT_FALSE(identical.is_shared);
+  EXPECT_EQ(identical.buf, memfile_chunk(step1, 0).buf);
+
+  /* Shared memory, but the data at this position did change. */
+  const MemFileChunk &shared = memfile_chunk(step2, 1);
+  EXPECT_FALSE(shared.is_identical);
+  EXPECT_TRUE(shared.is_shared);
+  EXPECT_EQ(shared.buf, memfile_chunk(step1, 2).buf);
+
+  const MemFileChunk &changed = memfile_chunk(step2, 2);
+  EXPECT_FALSE(changed.is_identical);
+  EXPECT_FALSE(changed.is_shared);
+  EXPECT_EQ(std::string(changed.buf, changed.size), d);
+
+  /* Merging gives the ownership of the reused buffers to the remaining step. */
+  BLO_memfile_merge(&step1, &step2);
+  EXPECT_FALSE(identical.is_identical);
+  EXPECT_FALSE(shared.is_shared);
+  EXPECT_EQ(std::string(identical.buf, identical.size), a);
+  EXPECT_EQ(std::string(shared.buf, shared.size), c);
+  BLO_memfile_free(&step2);
+}
+
+}  // namespace blender::tests
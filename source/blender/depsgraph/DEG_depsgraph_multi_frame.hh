@@ -0,0 +1,64 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Evaluation of many frames at the same time, for baking and exporting animations where the
+ * evaluation of a single frame doesn't use all cores. Every frame is evaluated by one of several
+ * independent dependency graphs, the results are passed to the caller in the order of the frames.
+ *
+ * This is only correct when the result of a frame doesn't depend on previous frames. Unbaked
+ * physics, particles and simulation zones are evaluated as if frames were skipped. Frame change
+ * handlers are not called either, as they may change original data.
+ */
+
+#include <functional>
+
+#include "BLI_function_ref.hh"
+#include "BLI_span.hh"
+
+#include "DEG_depsgraph.hh"
+
+namespace blender::deg::multi_frame {
+
+struct Params {
+  Main *bmain = nullptr;
+  Scene *scene = nullptr;
+  ViewLayer *view_layer = nullptr;
+  eEvaluationMode mode = DAG_EVAL_RENDER;
+
+  /**
+   * Builds the relations of each of the dependency graphs, e.g. with
+   * #DEG_graph_build_from_collection. The whole view layer is used when this is empty.
+   */
+  std::function<void(Depsgraph &depsgraph)> build_fn;
+
+  /** Maximum number of dependency graphs, zero to use one per thread. */
+  int max_depsgraphs = 0;
+  /**
+   * Limit for the memory used by all evaluated dependency graphs in bytes, zero for no limit.
+   * The memory used by a single dependency graph is estimated from the evaluation of the first
+   * frame, at least one dependency graph is always used.
+   */
+  int64_t memory_budget = 0;
+};
+
+/**
+ * Evaluate all \a frames and call \a frame_fn for each of them, in the same order as the frames
+ * are given. The callback is always called on the calling thread, with a dependency graph that is
+ * evaluated at the frame. Evaluated data must not be accessed anymore after the callback returned,
+ * because the dependency graph is reused for other frames. Returning false from the callback stops
+ * the evaluation of the remaining frames.
+ *
+ * Must be called from the main thread, the original data must not change while frames are being
+ * evaluated.
+ */
+void evaluate_frames(const Params &params,
+                     Span<float> frames,
+                     FunctionRef<bool(Depsgraph &depsgraph, float frame)> frame_fn);
+
+}  // namespace blender::deg::multi_frame
@@ -10,7 +10,12 @@
 
 #include "DNA_anim_types.h"
 
+#include "BLI_hash.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_vector.hh"
+
 #include "BKE_anim_data.hh"
+#include "BKE_lib_id.hh"
 
 #include "RNA_access.hh"
 #include "RNA_path.hh"
@@ -60,7 +65,10 @@ uint64_t AnimatedPropertyID::hash() const
   return uint64_t(((ptr1 >> 4) * 33) ^ (ptr2 >> 4));
 }
 
-AnimatedPropertyStorage::AnimatedPropertyStorage() : is_fully_initialized(false) {}
+AnimatedPropertyStorage::AnimatedPropertyStorage()
+    : is_fully_initialized(false), fcurves_hash(0), last_used_build(0), last_validated_build(0)
+{
+}
 
 void AnimatedPropertyStorage::initializeFromID(DepsgraphBuilderCache *builder_cache, const ID *id)
 {
@@ -83,12 +91,25 @@ void AnimatedPropertyStorage::initializeFromID(DepsgraphBuilderCache *builder_ca
     if (pointer_rna.owner_id != own_pointer_rna.owner_id) {
       animated_property_storage = builder_cache->ensureAnimatedPropertyStorage(
           pointer_rna.owner_id);
+      animated_property_storage->linked_ids.add(id->session_uid);
+      linked_ids.add(pointer_rna.owner_id->session_uid);
     }
     /* Set the property as animated. */
     animated_property_storage->tagPropertyAsAnimated(&pointer_rna, property_rna);
   });
 }
 
+uint64_t AnimatedPropertyStorage::hashFCurves(const ID *id)
+{
+  uint64_t hash = 0;
+  BKE_fcurves_id_cb(const_cast<ID *>(id), [&](ID * /*id*/, FCurve *fcurve) {
+    if (fcurve->rna_path != nullptr) {
+      hash = get_default_hash(hash, StringRef(fcurve->rna_path));
+    }
+  });
+  return hash;
+}
+
 void AnimatedPropertyStorage::tagPropertyAsAnimated(const AnimatedPropertyID &property_id)
 {
   animated_objects_set.add(property_id.data);
@@ -128,20 +149,89 @@ DepsgraphBuilderCache::~DepsgraphBuilderCache()
   }
 }
 
+void DepsgraphBuilderCache::beginBuild()
+{
+  build_index_++;
+  for (const uint id_session_uid : changed_ids_) {
+    invalidateAnimatedPropertyStorage(id_session_uid);
+  }
+  changed_ids_.clear();
+}
+
+void DepsgraphBuilderCache::endBuild()
+{
+  Vector<uint> unused_ids;
+  for (const auto item : animated_property_storage_map_.items()) {
+    if (item.value->last_used_build != build_index_) {
+      unused_ids.append(item.key);
+    }
+  }
+  for (const uint id_session_uid : unused_ids) {
+    invalidateAnimatedPropertyStorage(id_session_uid);
+  }
+}
+
+void DepsgraphBuilderCache::tagIDChanged(const ID *id)
+{
+  changed_ids_.add(id->session_uid);
+}
+
+void DepsgraphBuilderCache::invalidateAnimatedPropertyStorage(const uint id_session_uid)
+{
+  Vector<uint> ids_to_invalidate = {id_session_uid};
+  while (!ids_to_invalidate.is_empty()) {
+    AnimatedPropertyStorage *animated_property_storage =
+        animated_property_storage_map_.pop_default(ids_to_invalidate.pop_last(), nullptr);
+    if (animated_property_storage == nullptr) {
+      continue;
+    }
+    for (const uint linked_id : animated_property_storage->linked_ids) {
+      ids_to_invalidate.append(linked_id);
+    }
+    delete animated_property_storage;
+  }
+}
+
 AnimatedPropertyStorage *DepsgraphBuilderCache::ensureAnimatedPropertyStorage(const ID *id)
 {
-  return animated_property_storage_map_.lookup_or_add_cb(
-      id, []() { return new AnimatedPropertyStorage(); });
+  BLI_assert(id->session_uid != MAIN_ID_SESSION_UID_UNSET);
+  AnimatedPropertyStorage *animated_property_storage =
+      animated_property_storage_map_.lookup_or_add_cb(
+          id->session_uid, []() { return new AnimatedPropertyStorage(); });
+  animated_property_storage->last_used_build = build_index_;
+  return animated_property_storage;
 }
 
 AnimatedPropertyStorage *DepsgraphBuilderCache::ensureInitializedAnimatedPropertyStorage(
     const ID *id)
 {
   AnimatedPropertyStorage *animated_property_storage = ensureAnimatedPropertyStorage(id);
+  if (animated_property_storage->is_fully_initialized &&
+      animated_property_storage->last_validated_build != build_index_)
+  {
+    /* The storage was initialized by a previous build. F-Curves can be added or changed without
+     * tagging the animated ID, for example when the action is shared with other IDs. */
+    if (animated_property_storage->fcurves_hash != AnimatedPropertyStorage::hashFCurves(id)) {
+      invalidateAnimatedPropertyStorage(id->session_uid);
+      animated_property_storage = ensureAnimatedPropertyStorage(id);
+    }
+    else {
+      /* Keep the storages this one depends on, even when their IDs are not queried. */
+      for (const uint linked_id : animated_property_storage->linked_ids) {
+        AnimatedPropertyStorage *linked_storage = animated_property_storage_map_.lookup_default(
+            linked_id, nullptr);
+        if (linked_storage != nullptr) {
+          linked_storage->last_used_build = build_index_;
+        }
+      }
+    }
+  }
   if (!animated_property_storage->is_fully_initialized) {
     animated_property_storage->initializeFromID(this, id);
+    animated_property_storage->fcurves_hash = AnimatedPropertyStorage::hashFCurves(id);
     animated_property_storage->is_fully_initialized = true;
   }
+  animated_property_storage->last_validated_build = build_index_;
   return animated_property_storage;
 }
 
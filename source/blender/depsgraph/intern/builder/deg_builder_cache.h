@@ -51,6 +51,10 @@ class AnimatedPropertyStorage {
 
   void initializeFromID(DepsgraphBuilderCache *builder_cache, const ID *id);
 
+  /* Hash of the F-Curve paths the storage is initialized from, to detect animation changes
+   * between builds. */
+  static uint64_t hashFCurves(const ID *id);
+
   void tagPropertyAsAnimated(const AnimatedPropertyID &property_id);
   void tagPropertyAsAnimated(const PointerRNA *pointer_rna, const PropertyRNA *property_rna);
 
@@ -62,6 +66,17 @@ class AnimatedPropertyStorage {
   /* The storage is fully initialized from all F-Curves from corresponding ID. */
   bool is_fully_initialized;
 
+  /* Result of #hashFCurves at the time the storage was initialized. */
+  uint64_t fcurves_hash;
+  /* Last build which used the storage, see #DepsgraphBuilderCache::build_index_. */
+  int last_used_build;
+  /* Last build which checked the storage against the current F-Curves of the ID. */
+  int last_validated_build;
+  /* Session UIDs of IDs which had properties of this ID tagged as animated, or whose properties
+   * were tagged as animated when initializing this storage. The storages are invalidated
+   * together, since they contain each other's data. */
+  Set<uint> linked_ids;
+
   /* indexed by PointerRNA.data. */
   Set<const void *> animated_objects_set;
   Set<AnimatedPropertyID> animated_properties_set;
@@ -69,11 +84,22 @@ class AnimatedPropertyStorage {
   MEM_CXX_CLASS_ALLOC_FUNCS("AnimatedPropertyStorage");
 };
 
-/* Cached data which can be re-used by multiple builders. */
+/* Cached data which can be re-used by multiple builders.
+ *
+ * The cache is owned by the dependency graph and kept across relation updates, so that only
+ * the animation of IDs which changed since the previous build has to be resolved again. */
 class DepsgraphBuilderCache {
  public:
   ~DepsgraphBuilderCache();
 
+  /* Invalidate data of IDs which were tagged as changed since the previous build. */
+  void beginBuild();
+  /* Free data of IDs which were not used by the build, for example because they were deleted. */
+  void endBuild();
+
+  /* Remember that the ID was modified, its cached data is invalidated on the next build. */
+  void tagIDChanged(const ID *id);
+
   /* Makes sure storage for animated properties exists and initialized for the given ID. */
   AnimatedPropertyStorage *ensureAnimatedPropertyStorage(const ID *id);
   AnimatedPropertyStorage *ensureInitializedAnimatedPropertyStorage(const ID *id);
@@ -100,9 +126,18 @@ class DepsgraphBuilderCache {
     return animated_property_storage->isAnyPropertyAnimated(ptr);
   }
 
-  Map<const ID *, AnimatedPropertyStorage *> animated_property_storage_map_;
+  /* Indexed by session UID, which unlike the ID pointer is not re-used by another ID when the ID
+   * is freed between builds. */
+  Map<uint, AnimatedPropertyStorage *> animated_property_storage_map_;
 
   MEM_CXX_CLASS_ALLOC_FUNCS("DepsgraphBuilderCache");
+
+ private:
+  /* Free the storage of the ID and of all storages linked to it. */
+  void invalidateAnimatedPropertyStorage(uint id_session_uid);
+
+  Set<uint> changed_ids_;
+  int build_index_ = 0;
 };
 
 }  // namespace deg
@@ -18,6 +18,8 @@
 #include "deg_builder_relations.h"
 #include "deg_builder_transitive.h"
 
+#include "intern/eval/deg_eval_stats.h"
+
 namespace blender {
 
 static CLG_LogRef LOG = {"depsgraph"};
@@ -81,7 +83,8 @@ AbstractBuilderPipeline::AbstractBuilderPipeline(blender::Depsgraph *graph)
     : deg_graph_(reinterpret_cast<Depsgraph *>(graph)),
       bmain_(deg_graph_->bmain),
       scene_(deg_graph_->scene),
-      view_layer_(deg_graph_->view_layer)
+      view_layer_(deg_graph_->view_layer),
+      builder_cache_(*deg_graph_->builder_cache)
 {
 }
 
@@ -93,8 +96,10 @@ void AbstractBuilderPipeline::build()
   }
 
   build_step_sanity_check();
+  builder_cache_.beginBuild();
   build_step_nodes();
   build_step_relations();
+  builder_cache_.endBuild();
   build_step_finalize();
 
   if (need_sanity_checks()) {
@@ -151,6 +156,8 @@ void AbstractBuilderPipeline::build_step_finalize()
   if (G.debug_value == 799) {
     deg_graph_transitive_reduction(deg_graph_);
   }
+  /* Initial evaluation priorities, refined once the operations have been timed. */
+  deg_eval_stats_init_critical_paths(deg_graph_);
   /* Store pointers to commonly used evaluated datablocks. */
   deg_graph_->scene_cow = reinterpret_cast<Scene *>(
       deg_graph_->get_cow_id(&deg_graph_->scene->id));
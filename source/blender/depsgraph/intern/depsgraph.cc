@@ -22,6 +22,7 @@
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_debug.hh"
 
+#include "intern/builder/deg_builder_cache.h"
 #include "intern/depsgraph_physics.hh"
 #include "intern/depsgraph_registry.hh"
 #include "intern/depsgraph_relation.hh"
@@ -56,9 +57,11 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
       is_active(false),
       use_visibility_optimization(true),
       is_evaluating(false),
+      evaluations_since_critical_paths_update(0),
       is_render_pipeline_depsgraph(false),
       use_editors_update(false),
       physics_relations_effector(nullptr),
+      builder_cache(new DepsgraphBuilderCache()),
       update_count(0),
       sync_writeback(DEG_EVALUATE_SYNC_WRITEBACK_NO)
 {
@@ -75,6 +78,7 @@ Depsgraph::~Depsgraph()
 {
   clear_id_nodes();
   delete time_source;
+  delete builder_cache;
   BLI_spin_end(&lock);
 }
 
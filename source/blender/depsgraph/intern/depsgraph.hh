@@ -40,6 +40,7 @@ struct ViewLayer;
 
 namespace deg {
 
+class DepsgraphBuilderCache;
 struct IDNode;
 struct Node;
 struct OperationNode;
@@ -169,6 +170,11 @@ struct Depsgraph {
 
   bool is_evaluating;
 
+  /* Number of evaluations since the critical paths of the operations were updated from measured
+   * evaluation times. Operations are only timed when an update is due, see
+   * #deg_eval_stats_critical_paths_need_timing. */
+  int evaluations_since_critical_paths_update;
+
   /* Is set to truth for dependency graph which are used for post-processing (compositor and
    * sequencer).
    * Such dependency graph needs all view layers (so render pipeline can access names), but it
@@ -186,6 +192,9 @@ struct Depsgraph {
 
   light_linking::Cache light_linking_cache;
 
+  /* Data shared by the node and relation builders, kept between relation updates. */
+  DepsgraphBuilderCache *builder_cache;
+
   /* The number of times this graph has been evaluated. */
   uint64_t update_count;
 
@@ -0,0 +1,117 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include <algorithm>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_task.h"
+#include "BLI_task.hh"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_multi_frame.hh"
+
+#ifdef WITH_PYTHON
+#  include "BPY_extern.hh"
+#endif
+
+namespace blender::deg::multi_frame {
+
+static Depsgraph *depsgraph_create(const Params &params)
+{
+  Depsgraph *depsgraph = DEG_graph_new(
+      params.bmain, params.scene, params.view_layer, params.mode);
+  if (params.build_fn) {
+    params.build_fn(*depsgraph);
+  }
+  else {
+    DEG_graph_build_from_view_layer(depsgraph);
+  }
+  return depsgraph;
+}
+
+static int64_t depsgraphs_num_get(const Params &params,
+                                  const int64_t frames_num,
+                                  const int64_t memory_per_depsgraph)
+{
+  int64_t depsgraphs_num = params.max_depsgraphs > 0 ? params.max_depsgraphs :
+                                                       BLI_task_scheduler_num_threads();
+  if (params.memory_budget > 0) {
+    depsgraphs_num = std::min(depsgraphs_num,
+                              params.memory_budget / std::max<int64_t>(memory_per_depsgraph, 1));
+  }
+  return std::clamp<int64_t>(depsgraphs_num, 1, std::max<int64_t>(frames_num, 1));
+}
+
+void evaluate_frames(const Params &params,
+                     const Span<float> frames,
+                     const FunctionRef<bool(Depsgraph &depsgraph, float frame)> frame_fn)
+{
+  BLI_assert(BLI_thread_is_main());
+  if (frames.is_empty()) {
+    return;
+  }
+
+  Vector<Depsgraph *> depsgraphs;
+  BLI_SCOPED_DEFER([&]() {
+    for (Depsgraph *depsgraph : depsgraphs) {
+      DEG_graph_free(depsgraph);
+    }
+  });
+
+  /* The first frame is evaluated on its own, to know how much memory a dependency graph needs
+   * before creating the others. */
+  const int64_t memory_before = int64_t(MEM_get_memory_in_use());
+  depsgraphs.append(depsgraph_create(params));
+  DEG_evaluate_on_framechange(depsgraphs[0], frames[0]);
+  const int64_t memory_per_depsgraph = int64_t(MEM_get_memory_in_use()) - memory_before;
+  if (!frame_fn(*depsgraphs[0], frames[0])) {
+    return;
+  }
+
+  const Span<float> remaining_frames = frames.drop_front(1);
+  const int64_t depsgraphs_num = depsgraphs_num_get(
+      params, remaining_frames.size(), memory_per_depsgraph);
+  while (depsgraphs.size() < depsgraphs_num) {
+    depsgraphs.append(depsgraph_create(params));
+  }
+
+  /* Every dependency graph evaluates one frame of a batch. Using consecutive frames for the
+   * dependency graphs of a batch keeps the results in order without having to keep more than one
+   * evaluated state per dependency graph around. */
+  for (int64_t batch_start = 0; batch_start < remaining_frames.size();
+       batch_start += depsgraphs_num)
+  {
+    const Span<float> batch = remaining_frames.slice(
+        batch_start, std::min(depsgraphs_num, remaining_frames.size() - batch_start));
+
+#ifdef WITH_PYTHON
+    /* Release the GIL once for all dependency graphs, the worker threads don't hold it anyway. */
+    BPy_BEGIN_ALLOW_THREADS;
+#endif
+    threading::parallel_for(batch.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        DEG_evaluate_on_framechange(depsgraphs[i], batch[i]);
+      }
+    });
+#ifdef WITH_PYTHON
+    BPy_END_ALLOW_THREADS;
+#endif
+
+    for (const int64_t i : batch.index_range()) {
+      if (!frame_fn(*depsgraphs[i], batch[i])) {
+        return;
+      }
+    }
+  }
+}
+
+}  // namespace blender::deg::multi_frame
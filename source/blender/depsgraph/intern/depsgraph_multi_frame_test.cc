@@ -0,0 +1,89 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "testing/testing.h"
+#include "tests/blendfile_loading_base_test.h"
+
+#include "ANIM_action.hh"
+#include "ANIM_fcurve.hh"
+
+#include "BKE_collection.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_object.hh"
+
+#include "BLI_array.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_vector.hh"
+
+#include "BLO_readfile.hh"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_multi_frame.hh"
+#include "DEG_depsgraph_query.hh"
+
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+namespace blender::deg::multi_frame::tests {
+
+class DepsgraphMultiFrameTest : public BlendfileLoadingBaseTest {};
+
+TEST_F(DepsgraphMultiFrameTest, evaluate_frames)
+{
+  if (!blendfile_load("io_tests" SEP_STR "empty.blend")) {
+    return;
+  }
+  Main *bmain = bfile->main;
+  Scene *scene = bfile->curscene;
+
+  /* Animate the X location from 1 to 10 over the frames 1 to 10. */
+  Object *object = BKE_object_add_only_object(bmain, OB_EMPTY, "Animated");
+  BKE_collection_object_add(bmain, scene->master_collection, object);
+  animrig::Action &action = BKE_id_new<bAction>(bmain, "Action")->wrap();
+  animrig::Slot &slot = action.slot_add_for_id(object->id);
+  ASSERT_EQ(animrig::assign_action_and_slot(&action, &slot, object->id),
+            animrig::ActionSlotAssignmentResult::OK);
+  action.layer_keystrip_ensure();
+  animrig::StripKeyframeData &strip_data =
+      action.layer(0)->strip(0)->data<animrig::StripKeyframeData>(action);
+  animrig::KeyframeSettings settings = animrig::get_keyframe_settings(false);
+  settings.interpolation = BEZT_IPO_LIN;
+  strip_data.keyframe_insert(bmain, slot, {"location", 0}, {1.0f, 1.0f}, settings);
+  strip_data.keyframe_insert(bmain, slot, {"location", 0}, {10.0f, 10.0f}, settings);
+
+  Params params;
+  params.bmain = bmain;
+  params.scene = scene;
+  params.view_layer = bfile->cur_view_layer;
+  params.mode = DAG_EVAL_VIEWPORT;
+  params.max_depsgraphs = 3;
+
+  /* Not sorted, the callback has to be called in the given order anyway. */
+  const Array<float> frames = {4.0f, 2.0f, 3.0f, 7.0f, 5.0f, 1.0f, 9.0f};
+  Vector<float> callback_frames;
+  Vector<float> locations;
+  evaluate_frames(params, frames, [&](Depsgraph &depsgraph, const float frame) {
+    EXPECT_EQ(DEG_get_ctime(&depsgraph), frame);
+    callback_frames.append(frame);
+    locations.append(DEG_get_evaluated(&depsgraph, object)->loc[0]);
+    return true;
+  });
+  EXPECT_EQ(callback_frames.as_span(), frames.as_span());
+  EXPECT_EQ(locations.as_span(), frames.as_span());
+
+  /* Returning false stops the evaluation. */
+  callback_frames.clear();
+  evaluate_frames(params, frames, [&](Depsgraph & /*depsgraph*/, const float frame) {
+    callback_frames.append(frame);
+    return callback_frames.size() < 4;
+  });
+  EXPECT_EQ(callback_frames.as_span(), frames.as_span().take_front(4));
+}
+
+}  // namespace blender::deg::multi_frame::tests
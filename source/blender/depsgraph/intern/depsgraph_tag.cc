@@ -39,6 +39,7 @@
 #include "DEG_depsgraph_query.hh"
 
 #include "intern/builder/deg_builder.h"
+#include "intern/builder/deg_builder_cache.h"
 #include "intern/depsgraph.hh"
 #include "intern/depsgraph_registry.hh"
 #include "intern/depsgraph_update.hh"
@@ -293,6 +294,7 @@ void depsgraph_tag_component(Depsgraph *graph,
   }
   /* If component depends on copy-on-evaluation, tag it as well. */
   if (component_node->need_tag_cow_before_update(IDRecalcFlag(id_node->id_cow->recalc))) {
+    id_node->cow_tagging_components_mask |= (1ULL << int(component_type));
     depsgraph_id_tag_copy_on_write(graph, id_node, update_source);
   }
   if (component_type == NodeType::COPY_ON_EVAL) {
@@ -714,6 +716,11 @@ void graph_id_tag_update(
   IDNode *id_node = (graph != nullptr) ? graph->find_id_node(id) : nullptr;
   if (graph != nullptr) {
     DEG_graph_id_type_tag(reinterpret_cast<::blender::Depsgraph *>(graph), GS(id->name));
+    /* Data which is cached for the graph builders might be out of date now. Tags from the
+     * builder itself don't change the ID. */
+    if (update_source != DEG_UPDATE_SOURCE_RELATIONS) {
+      graph->builder_cache->tagIDChanged(id);
+    }
   }
   if (flags == 0) {
     deg_graph_node_tag_zero(bmain, graph, id_node, update_source);
@@ -963,6 +970,7 @@ void DEG_ids_clear_recalc(Depsgraph *depsgraph, const bool backup)
      * the recalc flag. */
     id_node->is_user_modified = false;
     id_node->is_cow_explicitly_tagged = false;
+    id_node->cow_tagging_components_mask = 0;
     deg_graph_clear_id_recalc_flags(id_node->id_cow);
     if (deg_graph->is_active) {
       deg_graph_clear_id_recalc_flags(id_node->id_orig);
@@ -8,15 +8,20 @@
  * Evaluation engine entry-points for Depsgraph Engine.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <mutex>
 
 #include "intern/eval/deg_eval.h"
 
 #include "BLI_function_ref.hh"
 #include "BLI_gsqueue.h"
+#include "BLI_mutex.hh"
+#include "BLI_scratch_allocator.hh"
 #include "BLI_task.h"
 #include "BLI_time.h"
+#include "BLI_vector.hh"
 
 #include "BKE_global.hh"
 
@@ -76,25 +81,67 @@ enum class EvaluationStage {
   SINGLE_THREADED_WORKAROUND,
 };
 
+/* Operations which are ready to be evaluated in the task pool. Every operation in the queue has a
+ * task in the pool, which evaluates the ready operation with the longest critical path at the time
+ * the task starts. That way long dependency chains (e.g. of a character rig) are started as early
+ * as possible, instead of in the order the operations happened to become ready.
+ *
+ * A task continues with the most important child of its operation directly, so only branches of
+ * the graph go through the queue. */
+class ReadyOperationsQueue {
+ private:
+  Mutex mutex_;
+  Vector<OperationNode *> heap_;
+
+  static bool compare(const OperationNode *a, const OperationNode *b)
+  {
+    return a->critical_path_time < b->critical_path_time;
+  }
+
+ public:
+  void push(OperationNode *node)
+  {
+    std::lock_guard lock{mutex_};
+    heap_.append(node);
+    std::push_heap(heap_.begin(), heap_.end(), compare);
+  }
+
+  OperationNode *pop()
+  {
+    std::lock_guard lock{mutex_};
+    BLI_assert(!heap_.is_empty());
+    std::pop_heap(heap_.begin(), heap_.end(), compare);
+    return heap_.pop_last();
+  }
+};
+
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Measure the evaluation time of operations, for statistics or to update the critical paths. */
+  bool do_timing;
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
+  ReadyOperationsQueue ready_operations;
+  std::atomic<int64_t> evaluated_operations_num = 0;
 };
 
-void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
+void evaluate_node(DepsgraphEvalState *state, OperationNode *operation_node)
 {
   blender::Depsgraph *depsgraph = reinterpret_cast<blender::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
+  /* Temporary containers of the operation reuse the scratch memory of this thread, it is all
+   * reclaimed once the operation is done. */
+  ScratchScope scratch_scope;
   /* Perform operation. */
-  if (state->do_stats) {
+  if (state->do_timing) {
     const double start_time = BLI_time_now_seconds();
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += BLI_time_now_seconds() - start_time;
+    deg_eval_stats_record_operation(
+        operation_node, BLI_time_now_seconds() - start_time, state->do_stats);
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -105,21 +152,44 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
    * This is a thread-safe modification as the node's flags are only read for a non-scheduled nodes
    * and this node has been scheduled. */
   operation_node->flag &= ~DEPSOP_FLAG_CLEAR_ON_EVAL;
+
+  state->evaluated_operations_num.fetch_add(1, std::memory_order_relaxed);
+}
+
+void schedule_node_to_pool(DepsgraphEvalState *state, TaskPool *pool, OperationNode *node)
+{
+  state->ready_operations.push(node);
+  BLI_task_pool_push(pool, deg_task_run_func, nullptr, false, nullptr);
 }
 
-void deg_task_run_func(TaskPool *pool, void *taskdata)
+void deg_task_run_func(TaskPool *pool, void * /*taskdata*/)
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = static_cast<DepsgraphEvalState *>(userdata_v);
 
-  /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  /* Evaluate the most important node which is ready, not necessarily the one this task was pushed
+   * for. */
+  OperationNode *operation_node = state->ready_operations.pop();
+  Vector<OperationNode *, 16> ready_children;
+  while (operation_node != nullptr) {
+    evaluate_node(state, operation_node);
 
-  /* Schedule children. */
-  schedule_children(state, operation_node, [&](OperationNode *node) {
-    BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
-  });
+    /* Continue with the child with the longest critical path, schedule the others. */
+    ready_children.clear();
+    schedule_children(
+        state, operation_node, [&](OperationNode *node) { ready_children.append(node); });
+    operation_node = nullptr;
+    for (OperationNode *node : ready_children) {
+      if (operation_node == nullptr) {
+        operation_node = node;
+        continue;
+      }
+      if (node->critical_path_time > operation_node->critical_path_time) {
+        std::swap(node, operation_node);
+      }
+      schedule_node_to_pool(state, pool, node);
+    }
+  }
 }
 
 bool check_operation_node_visible(const DepsgraphEvalState *state, OperationNode *op_node)
@@ -317,9 +387,8 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, [&](OperationNode *node) {
-    BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
-  });
+  schedule_graph(state,
+                 [&](OperationNode *node) { schedule_node_to_pool(state, task_pool, node); });
   BLI_task_pool_work_and_wait(task_pool);
 }
 
@@ -411,6 +480,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_timing = state.do_stats || deg_eval_stats_critical_paths_need_timing(graph);
 
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -466,6 +536,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     deg_eval_stats_aggregate(graph);
   }
 
+  /* Update priorities with the new timings. */
+  deg_eval_stats_update_critical_paths_if_needed(graph, state.evaluated_operations_num);
+
   /* Clear any uncleared tags. */
   deg_graph_clear_tags(graph);
   graph->is_evaluating = false;
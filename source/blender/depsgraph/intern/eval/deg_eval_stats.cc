@@ -8,7 +8,12 @@
 
 #include "intern/eval/deg_eval_stats.h"
 
+#include <algorithm>
+
+#include "BLI_vector.hh"
+
 #include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
 
 #include "intern/node/deg_node.hh"
 #include "intern/node/deg_node_component.hh"
@@ -37,4 +42,116 @@ void deg_eval_stats_aggregate(Depsgraph *graph)
   }
 }
 
+void deg_eval_stats_record_operation(OperationNode *op_node,
+                                     const double time,
+                                     const bool do_stats)
+{
+  Node::Stats &stats = op_node->stats;
+  if (do_stats) {
+    stats.current_time += time;
+  }
+  /* Weigh recent evaluations more, the cost of an operation changes with the data it works on. */
+  stats.average_time = (stats.average_time == 0.0) ? time :
+                                                     stats.average_time * 0.75 + time * 0.25;
+}
+
+/* Number of evaluations after which the critical paths are updated with new timings. The costs of
+ * operations rarely change much between frames, so this is mostly to follow changes of e.g. the
+ * subdivision level or the number of particles. */
+static constexpr int critical_paths_update_interval = 100;
+
+/* Cost of operations which were not evaluated yet, so that the number of operations in a chain
+ * decides about the priority when nothing is measured yet. */
+static constexpr double unknown_operation_time = 1e-6;
+
+/* Markers for #OperationNode::critical_path_time while the critical paths are calculated. */
+static constexpr double critical_path_not_visited = -1.0;
+static constexpr double critical_path_in_progress = -2.0;
+
+static bool is_critical_path_relation(const Relation *rel)
+{
+  return rel->to->type == NodeType::OPERATION && (rel->flag & RELATION_FLAG_CYCLIC) == 0;
+}
+
+static void update_critical_paths(Depsgraph *graph)
+{
+  for (OperationNode *op_node : graph->operations) {
+    op_node->critical_path_time = critical_path_not_visited;
+  }
+  /* Depth-first traversal along the outgoing relations, the critical path of an operation is known
+   * once all its children are handled. An explicit stack is used because chains of operations can
+   * be very long in big scenes. */
+  struct StackItem {
+    OperationNode *op_node;
+    int64_t next_outlink;
+  };
+  Vector<StackItem> stack;
+  for (OperationNode *root_node : graph->operations) {
+    if (root_node->critical_path_time != critical_path_not_visited) {
+      continue;
+    }
+    root_node->critical_path_time = critical_path_in_progress;
+    stack.append({root_node, 0});
+    while (!stack.is_empty()) {
+      StackItem &item = stack.last();
+      OperationNode *op_node = item.op_node;
+      if (item.next_outlink < op_node->outlinks.size()) {
+        Relation *rel = op_node->outlinks[item.next_outlink++];
+        if (!is_critical_path_relation(rel)) {
+          continue;
+        }
+        OperationNode *child = static_cast<OperationNode *>(rel->to);
+        if (child->critical_path_time == critical_path_not_visited) {
+          child->critical_path_time = critical_path_in_progress;
+          stack.append({child, 0});
+        }
+        continue;
+      }
+      double children_time = 0.0;
+      for (const Relation *rel : op_node->outlinks) {
+        if (!is_critical_path_relation(rel)) {
+          continue;
+        }
+        const OperationNode *child = static_cast<const OperationNode *>(rel->to);
+        /* Children which are still in progress are only possible with cycles which were not
+         * detected, ignore those relations. */
+        children_time = std::max(children_time, child->critical_path_time);
+      }
+      const double average_time = op_node->stats.average_time;
+      op_node->critical_path_time = (average_time == 0.0 ? unknown_operation_time :
+                                                           average_time) +
+                                    children_time;
+      stack.remove_last();
+    }
+  }
+}
+
+void deg_eval_stats_init_critical_paths(Depsgraph *graph)
+{
+  update_critical_paths(graph);
+  /* Time the first evaluation, the operations are all new. */
+  graph->evaluations_since_critical_paths_update = critical_paths_update_interval;
+}
+
+bool deg_eval_stats_critical_paths_need_timing(const Depsgraph *graph)
+{
+  return graph->evaluations_since_critical_paths_update >= critical_paths_update_interval;
+}
+
+void deg_eval_stats_update_critical_paths_if_needed(Depsgraph *graph,
+                                                    const int64_t evaluated_operations_num)
+{
+  /* Small updates (like tweaking a single property) don't time enough operations to be useful, so
+   * keep timing the following evaluations until a big one, e.g. a frame change. */
+  if (deg_eval_stats_critical_paths_need_timing(graph) &&
+      evaluated_operations_num * 4 >= int64_t(graph->operations.size()))
+  {
+    update_critical_paths(graph);
+    graph->evaluations_since_critical_paths_update = 0;
+    return;
+  }
+  graph->evaluations_since_critical_paths_update = std::min(
+      graph->evaluations_since_critical_paths_update + 1, critical_paths_update_interval);
+}
+
 }  // namespace blender::deg
@@ -8,11 +8,31 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace blender::deg {
 
 struct Depsgraph;
+struct OperationNode;
 
 /* Aggregate operation timings to overall component and ID nodes timing. */
 void deg_eval_stats_aggregate(Depsgraph *graph);
 
+/* Account the time spent on evaluating the operation, in seconds. The average time is always
+ * updated, the time of the current evaluation only when statistics are gathered. */
+void deg_eval_stats_record_operation(OperationNode *op_node, double time, bool do_stats);
+
+/* Calculate the initial critical path time of all operations after the relations were built, from
+ * the length of the operation chains. Needs cyclic relations to be tagged already. */
+void deg_eval_stats_init_critical_paths(Depsgraph *graph);
+
+/* Whether the operations are to be timed in the next evaluation, so that the critical paths can be
+ * updated afterwards. This is the case after the relations were built and then periodically. */
+bool deg_eval_stats_critical_paths_need_timing(const Depsgraph *graph);
+
+/* Called after every evaluation. Updates the critical paths if the evaluation was timed and
+ * touched a significant part of the graph. */
+void deg_eval_stats_update_critical_paths_if_needed(Depsgraph *graph,
+                                                    int64_t evaluated_operations_num);
+
 }  // namespace blender::deg
@@ -172,6 +172,9 @@ struct Node {
     void reset_current();
     /* Time spent on this node during current graph evaluation. */
     double current_time;
+    /* Moving average of the evaluation time over the previous graph evaluations. Zero when the
+     * node was not evaluated yet. */
+    double average_time;
   };
   /* Relationships between nodes
    * The reason why all depsgraph nodes are descended from this type (apart
@@ -52,6 +52,8 @@ void IDNode::init(const ID *id, const char * /*subdata*/)
   is_collection_fully_expanded = false;
   has_base = false;
   is_user_modified = false;
+  is_cow_explicitly_tagged = false;
+  cow_tagging_components_mask = 0;
   id_cow_recalc_backup = 0;
 
   visible_components_mask = 0;
@@ -129,6 +129,10 @@ struct IDNode : public Node {
   /* Copy-on-Write component has been explicitly tagged for update. */
   bool is_cow_explicitly_tagged;
 
+  /* Components whose update tag implied a copy-on-evaluation update. Allows the update to only
+   * synchronize settings when nothing but the parameters changed. */
+  IDComponentsMask cow_tagging_components_mask;
+
   /* Accumulate recalc flags from multiple update passes. */
   int id_cow_recalc_backup;
 
@@ -291,6 +291,11 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Estimated time needed to evaluate this operation and the longest chain of operations depending
+   * on it. Ready operations with the longest critical path are evaluated first, so that they don't
+   * end up delaying the whole evaluation when they are started last. */
+  double critical_path_time;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
@@ -99,6 +99,7 @@ static wmOperatorStatus wm_obj_export_exec(bContext *C, wmOperator *op)
   export_params.export_animation = RNA_boolean_get(op->ptr, "export_animation");
   export_params.start_frame = RNA_int_get(op->ptr, "start_frame");
   export_params.end_frame = RNA_int_get(op->ptr, "end_frame");
+  export_params.export_animation_parallel = RNA_boolean_get(op->ptr, "export_animation_parallel");
 
   export_params.forward_axis = eIOAxis(RNA_enum_get(op->ptr, "forward_axis"));
   export_params.up_axis = eIOAxis(RNA_enum_get(op->ptr, "up_axis"));
@@ -212,6 +213,7 @@ static void ui_obj_export_settings(const bContext *C, ui::Layout &layout, Pointe
 
     col.prop(ptr, "start_frame", UI_ITEM_NONE, IFACE_("Frame Start"), ICON_NONE);
     col.prop(ptr, "end_frame", UI_ITEM_NONE, IFACE_("End"), ICON_NONE);
+    col.prop(ptr, "export_animation_parallel", UI_ITEM_NONE, IFACE_("Parallel"), ICON_NONE);
   }
 }
 
@@ -307,6 +309,12 @@ void WM_OT_obj_export(wmOperatorType *ot)
               "The last frame to be exported",
               INT_MIN,
               INT_MAX);
+  RNA_def_boolean(ot->srna,
+                  "export_animation_parallel",
+                  false,
+                  "Parallel Frames",
+                  "Evaluate several frames at the same time, using more memory. Only use when "
+                  "frames don't depend on previous frames, e.g. without unbaked simulations");
   /* Object transform options. */
   prop = RNA_def_enum(
       ot->srna, "forward_axis", io_transform_axis, IO_AXIS_NEGATIVE_Z, "Forward Axis", "");
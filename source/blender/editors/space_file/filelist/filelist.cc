@@ -2471,6 +2471,78 @@ static int filelist_readjob_list_lib_populate_from_index(FileListReadJob *job_pa
   return read_from_index + navigate_to_parent_len;
 }
 
+/**
+ * List the library content from the ID index stored at the end of the file, which avoids reading
+ * the whole file. Asset meta-data is not part of that index, so this is only possible when none
+ * of the listed data-blocks are assets.
+ *
+ * \return The number of entries added, or no value if the file has to be read instead.
+ */
+static std::optional<int> filelist_readjob_list_lib_from_id_index(
+    FileListReadJob *job_params,
+    const char *dir,
+    const char *group,
+    ListBaseT<FileListInternEntry> *entries,
+    const ListLibOptions options)
+{
+  const std::optional<Vector<BLOIDIndexEntry>> id_index = BLO_blendfile_id_index_read(dir);
+  if (!id_index) {
+    return std::nullopt;
+  }
+
+  const int group_idcode = group ? groupname_to_code(group) : 0;
+  const bool list_datablocks = group || (options & LIST_LIB_RECURSIVE);
+  Vector<int> idcodes;
+  for (const BLOIDIndexEntry &id_entry : *id_index) {
+    if (!idcodes.contains(id_entry.idcode)) {
+      idcodes.append(id_entry.idcode);
+    }
+    if (list_datablocks && id_entry.is_asset && !id_entry.is_packed &&
+        (!group || id_entry.idcode == group_idcode))
+    {
+      return std::nullopt;
+    }
+  }
+  /* Mimic the order of #BLO_blendhandle_get_linkable_groups and
+   * #BLO_blendhandle_get_datablock_info, which list the last items of the file first. */
+  std::reverse(idcodes.begin(), idcodes.end());
+
+  int added_entries_len = 0;
+  if (options & LIST_LIB_ADD_PARENT) {
+    BLI_addtail(entries, filelist_readjob_list_lib_navigate_to_parent_entry_create(job_params));
+    added_entries_len++;
+  }
+
+  for (const int idcode : idcodes) {
+    if (group && idcode != group_idcode) {
+      continue;
+    }
+    const char *group_name = BKE_idtype_idcode_to_name(idcode);
+    if (!group) {
+      BLI_addtail(entries, filelist_readjob_list_lib_group_create(job_params, idcode, group_name));
+      added_entries_len++;
+    }
+    if (!list_datablocks || (options & LIST_LIB_ASSETS_ONLY)) {
+      /* There are no assets to list, see above. */
+      continue;
+    }
+    for (int i = id_index->size() - 1; i >= 0; i--) {
+      const BLOIDIndexEntry &id_entry = (*id_index)[i];
+      if (id_entry.idcode != idcode || id_entry.is_packed) {
+        continue;
+      }
+      BLODataBlockInfo datablock_info{};
+      STRNCPY(datablock_info.name, id_entry.name.c_str());
+      datablock_info.no_preview_found = !id_entry.has_preview;
+      filelist_readjob_list_lib_add_datablock(
+          job_params, entries, &datablock_info, !group, idcode, group_name);
+      added_entries_len++;
+    }
+  }
+
+  return added_entries_len;
+}
+
 /**
  * \return The number of entries found if the \a root path points to a valid library file.
  *         Otherwise returns no value (#std::nullopt).
@@ -2522,6 +2594,15 @@ static std::optional<int> filelist_readjob_list_lib(FileListReadJob *job_params,
     }
   }
 
+  if (std::optional<int> entries_read = filelist_readjob_list_lib_from_id_index(
+          job_params, dir, group, entries, options))
+  {
+    if (use_indexer) {
+      ED_file_indexer_entries_clear(&indexer_entries);
+    }
+    return entries_read;
+  }
+
   /* Open the library file. */
   BlendFileReadReport bf_reports{};
   libfiledata = BLO_blendhandle_from_file(dir, &bf_reports);
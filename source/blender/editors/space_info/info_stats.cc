@@ -28,6 +28,7 @@
 #include "BLI_enum_flags.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_geom.h"
+#include "BLI_scratch_allocator.hh"
 #include "BLI_set.hh"
 #include "BLI_span.hh"
 #include "BLI_string.h"
@@ -793,7 +794,8 @@ const char *ED_info_statusbar_string_ex(Main *bmain,
     if (info[0]) {
       ofs += BLI_snprintf_utf8_rlen(info + ofs, len - ofs, " | ");
     }
-    uintptr_t mem_in_use = MEM_get_memory_in_use();
+    /* Scratch memory of the threads is not allocated with the guarded allocator. */
+    uintptr_t mem_in_use = MEM_get_memory_in_use() + uintptr_t(scratch_allocator_memory_in_use());
     BLI_str_format_byte_unit(formatted_mem, mem_in_use, false);
     ofs += BLI_snprintf_utf8_rlen(info + ofs, len - ofs, IFACE_("Memory: %s"), formatted_mem);
   }
@@ -219,6 +219,9 @@ static void ed_undo_step_post(bContext *C,
   WM_event_add_notifier(C, NC_WINDOW, nullptr);
   WM_event_add_notifier(C, NC_WM | ND_UNDO, nullptr);
 
+  /* The data now differs from what may have been written in the last auto-save. */
+  wm->runtime->autosave_has_changes = true;
+
   WM_toolsystem_refresh_active(C);
   WM_toolsystem_refresh_screen_all(bmain);
 
@@ -4,6 +4,7 @@
 
 #include "FN_multi_function_procedure_executor.hh"
 
+#include "BLI_scratch_allocator.hh"
 #include "BLI_stack.hh"
 
 namespace blender::fn::multi_function {
@@ -127,7 +128,7 @@ class ValueAllocator : NonCopyable, NonMovable {
   static constexpr int min_alignment = 64;
 
   /** All buffers in the free-lists below have been allocated with this allocator. */
-  LinearAllocator<> &linear_allocator_;
+  LinearAllocator<ScratchAllocator> &linear_allocator_;
 
   /**
    * Use stacks so that the most recently used buffers are reused first. This improves cache
@@ -149,7 +150,10 @@ class ValueAllocator : NonCopyable, NonMovable {
   Map<const CPPType *, Stack<void *>> single_value_free_lists_;
 
  public:
-  ValueAllocator(LinearAllocator<> &linear_allocator) : linear_allocator_(linear_allocator) {}
+  ValueAllocator(LinearAllocator<ScratchAllocator> &linear_allocator)
+      : linear_allocator_(linear_allocator)
+  {
+  }
 
   VariableValue_GVArray *obtain_GVArray(const GVArray &varray)
   {
@@ -820,7 +824,7 @@ class VariableStates {
   const IndexMask &full_mask_;
 
  public:
-  VariableStates(LinearAllocator<> &linear_allocator,
+  VariableStates(LinearAllocator<ScratchAllocator> &linear_allocator,
                  const Procedure &procedure,
                  const IndexMask &full_mask)
       : value_allocator_(linear_allocator),
@@ -1161,8 +1165,11 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
 {
   BLI_assert(procedure_.validate());
 
+  /* Buffers for intermediate variables are taken from the arena of the current thread, which
+   * avoids contention in the system allocator when many threads evaluate procedures. */
+  ScratchScope scratch_scope;
   AlignedBuffer<512, 64> local_buffer;
-  LinearAllocator<> linear_allocator;
+  LinearAllocator<ScratchAllocator> linear_allocator;
   linear_allocator.provide_buffer(local_buffer);
 
   VariableStates variable_states{linear_allocator, procedure_, full_mask};
@@ -62,25 +62,23 @@ static Array<NeighborCurves> find_curve_neighbors(const Span<float3> root_positi
 {
   const int tot_added_curves = root_positions.size();
   Array<NeighborCurves> neighbors_per_curve(tot_added_curves);
-  threading::parallel_for(IndexRange(tot_added_curves), 128, [&](const IndexRange range) {
-    for (const int i : range) {
-      const float3 root = root_positions[i];
-      std::array<KDTreeNearest_3d, max_neighbors> nearest_n;
-      const int found_neighbors = kdtree_3d_find_nearest_n(
-          &old_roots_kdtree, root, nearest_n.data(), max_neighbors);
-      float tot_weight = 0.0f;
-      for (const int neighbor_i : IndexRange(found_neighbors)) {
-        KDTreeNearest_3d &nearest = nearest_n[neighbor_i];
-        const float weight = 1.0f / std::max(nearest.dist, 0.00001f);
-        tot_weight += weight;
-        neighbors_per_curve[i].append({nearest.index, weight});
-      }
-      /* Normalize weights. */
-      for (NeighborCurve &neighbor : neighbors_per_curve[i]) {
-        neighbor.weight /= tot_weight;
-      }
-    }
-  });
+  kdtree_find_nearest_n_batch<float3>(
+      old_roots_kdtree,
+      root_positions,
+      IndexRange(tot_added_curves),
+      max_neighbors,
+      [&](const int i, const Span<KDTreeNearest_3d> nearest_n) {
+        float tot_weight = 0.0f;
+        for (const KDTreeNearest_3d &nearest : nearest_n) {
+          const float weight = 1.0f / std::max(nearest.dist, 0.00001f);
+          tot_weight += weight;
+          neighbors_per_curve[i].append({nearest.index, weight});
+        }
+        /* Normalize weights. */
+        for (NeighborCurve &neighbor : neighbors_per_curve[i]) {
+          neighbor.weight /= tot_weight;
+        }
+      });
   return neighbors_per_curve;
 }
 
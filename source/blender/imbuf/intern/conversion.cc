@@ -432,9 +432,9 @@ void IMB_buffer_float_from_float(float *rect_to,
           }
         }
         else {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            srgb_to_linearrgb_v4(to, from);
-          }
+          srgb_to_linearrgb_v4_array(reinterpret_cast<float (*)[4]>(to),
+                                     reinterpret_cast<const float (*)[4]>(from),
+                                     size_t(width));
         }
       }
       else if (profile_to == IB_PROFILE_SRGB) {
@@ -445,9 +445,9 @@ void IMB_buffer_float_from_float(float *rect_to,
           }
         }
         else {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            linearrgb_to_srgb_v4(to, from);
-          }
+          linearrgb_to_srgb_v4_array(reinterpret_cast<float (*)[4]>(to),
+                                     reinterpret_cast<const float (*)[4]>(from),
+                                     size_t(width));
         }
       }
     }
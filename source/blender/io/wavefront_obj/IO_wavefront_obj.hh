@@ -40,6 +40,12 @@ struct OBJExportParams {
   int start_frame = INT_MIN;
   /** The last frame to be exported. */
   int end_frame = INT_MAX;
+  /**
+   * Evaluate several frames at the same time on separate dependency graphs. Only gives the same
+   * result when the evaluation of a frame doesn't depend on previous frames, e.g. without unbaked
+   * simulations.
+   */
+  bool export_animation_parallel = false;
 
   /* Geometry Transform options. */
   eIOAxis forward_axis = IO_AXIS_NEGATIVE_Z;
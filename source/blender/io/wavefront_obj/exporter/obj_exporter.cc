@@ -26,6 +26,8 @@
 #include "BLI_task.hh"
 #include "BLI_vector.hh"
 
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_multi_frame.hh"
 #include "DEG_depsgraph_query.hh"
 
 #include "ED_object.hh"
@@ -371,6 +373,50 @@ bool append_frame_to_filename(const char *filepath,
   return BLI_path_extension_replace(r_filepath_with_frames, FILE_MAX, ".obj");
 }
 
+void export_frames_parallel(Main *bmain,
+                            Scene *scene,
+                            ViewLayer *view_layer,
+                            Collection *collection,
+                            const OBJExportParams &export_params)
+{
+  deg::multi_frame::Params params;
+  params.bmain = bmain;
+  params.scene = scene;
+  params.view_layer = view_layer;
+  params.mode = export_params.export_eval_mode;
+  /* Same dependency graph contents as #OBJDepsgraph. */
+  params.build_fn = [&](Depsgraph &depsgraph) {
+    if (collection) {
+      DEG_graph_build_from_collection(&depsgraph, collection);
+    }
+    else if (export_params.export_eval_mode == DAG_EVAL_RENDER) {
+      DEG_graph_build_for_all_objects(&depsgraph);
+    }
+    else {
+      DEG_graph_build_from_view_layer(&depsgraph);
+    }
+  };
+
+  Vector<float> frames;
+  for (int frame = export_params.start_frame; frame <= export_params.end_frame; frame++) {
+    frames.append(float(frame));
+  }
+
+  char filepath_with_frames[FILE_MAX];
+  deg::multi_frame::evaluate_frames(
+      params, frames, [&](Depsgraph &depsgraph, const float frame) {
+        const bool filepath_ok = append_frame_to_filename(
+            export_params.filepath, int(frame), filepath_with_frames);
+        if (!filepath_ok) {
+          CLOG_ERROR(&LOG, "File Path too long: %s", filepath_with_frames);
+          return false;
+        }
+        fmt::println("Writing to {}", filepath_with_frames);
+        export_frame(&depsgraph, export_params, filepath_with_frames);
+        return true;
+      });
+}
+
 void exporter_main(bContext *C, const OBJExportParams &export_params)
 {
   ed::object::mode_set(C, OB_MODE_OBJECT);
@@ -389,6 +435,15 @@ void exporter_main(bContext *C, const OBJExportParams &export_params)
     }
   }
 
+  if (export_params.export_animation && export_params.export_animation_parallel) {
+    export_frames_parallel(CTX_data_main(C),
+                           CTX_data_scene(C),
+                           CTX_data_view_layer(C),
+                           collection,
+                           export_params);
+    return;
+  }
+
   OBJDepsgraph obj_depsgraph(C, export_params.export_eval_mode, collection);
   Scene *scene = DEG_get_input_scene(obj_depsgraph.get());
   const char *filepath = export_params.filepath;
@@ -18,6 +18,9 @@ namespace blender {
 
 struct bContext;
 struct Collection;
+struct Main;
+struct Scene;
+struct ViewLayer;
 
 namespace io::obj {
 
@@ -86,6 +89,18 @@ void export_objects(const OBJExportParams &export_params,
 std::pair<Vector<std::unique_ptr<OBJMesh>>, Vector<std::unique_ptr<IOBJCurve>>>
 filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_params);
 
+/**
+ * Export every frame from `export_params.start_frame` to `export_params.end_frame` to its own
+ * file, evaluating several frames in parallel on separate dependency graphs. The dependency graphs
+ * contain the `collection` if it's not null, like #OBJDepsgraph.
+ * This function is normally called from `exporter_main`, but is exposed here for testing purposes.
+ */
+void export_frames_parallel(Main *bmain,
+                            Scene *scene,
+                            ViewLayer *view_layer,
+                            Collection *collection,
+                            const OBJExportParams &export_params);
+
 /**
  * Append the current frame number in the `.OBJ` file name.
  *
@@ -272,6 +272,42 @@ static bool strings_equal_after_first_lines(const std::string &a, const std::str
   return true;
 }
 
+TEST_F(OBJExportTest, export_frames_parallel)
+{
+  if (!load_file_and_depsgraph(all_objects_file)) {
+    ADD_FAILURE();
+    return;
+  }
+  BKE_tempdir_init(nullptr);
+  const std::string tempdir = std::string(BKE_tempdir_base());
+
+  OBJExportParams params;
+  params.export_materials = false;
+  params.export_animation = true;
+  params.export_animation_parallel = true;
+  params.start_frame = 1;
+  params.end_frame = 4;
+  STRNCPY(params.filepath, (tempdir + "parallel_frames.obj").c_str());
+  export_frames_parallel(
+      bfile->main, bfile->curscene, bfile->cur_view_layer, nullptr, params);
+
+  /* Compare with exporting the frames one after another. */
+  for (int frame = params.start_frame; frame <= params.end_frame; frame++) {
+    char parallel_file_path[FILE_MAX];
+    ASSERT_TRUE(append_frame_to_filename(params.filepath, frame, parallel_file_path));
+    const std::string serial_file_path = tempdir + "serial_frame.obj";
+    DEG_evaluate_on_framechange(depsgraph, float(frame));
+    export_frame(depsgraph, params, serial_file_path.c_str());
+
+    const std::string parallel_str = read_temp_file_in_string(parallel_file_path);
+    const std::string serial_str = read_temp_file_in_string(serial_file_path);
+    EXPECT_FALSE(parallel_str.empty());
+    EXPECT_TRUE(strings_equal_after_first_lines(parallel_str, serial_str));
+    BLI_delete(parallel_file_path, false, false);
+    BLI_delete(serial_file_path.c_str(), false, false);
+  }
+}
+
 /* From here on, tests are whole file tests, testing for golden output. */
 class OBJExportRegressionTest : public OBJExportTest {
  public:
@@ -801,6 +801,7 @@ struct UserDef_Experimental {
   char write_legacy_blend_file_format = 0;
   char no_data_block_packing = 0;
   char use_paint_debug = 0;
+  char no_evaluated_mesh_cache = 0;
   char SANITIZE_AFTER_HERE = {};
   /* The following options are automatically sanitized (set to 0)
    * when the release cycle is not alpha. */
@@ -810,7 +811,7 @@ struct UserDef_Experimental {
   char use_shader_node_previews = 0;
   char use_geometry_nodes_lists = 0;
   char use_geometry_bundle = 0;
-  char _pad[4] = {};
+  char _pad[3] = {};
 };
 
 #define USER_EXPERIMENTAL_TEST(userdef, member) (((userdef)->experimental).member)
@@ -899,7 +900,9 @@ struct UserDef {
   short versions = 1;
   short dbl_click_time = 350;
 
-  char _pad0[2] = {};
+  /** Zstandard compression level used when saving compressed .blend files. */
+  char file_compression_level = 3;
+  char _pad0[1] = {};
 
   /** Space around each area. Inter-editor gap width. */
   char border_width = 2;
@@ -28,6 +28,7 @@
 #include "BLI_math_matrix_types.hh"
 #include "BLI_memarena.h"
 #include "BLI_set.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "DNA_genfile.h"
@@ -1149,6 +1150,12 @@ static void reconstruct_structs(const DNA_ReconstructInfo *reconstruct_info,
                                 const char *old_blocks,
                                 char *new_blocks);
 
+/**
+ * Approximate amount of data (in bytes) converted by a single task when reconstructing arrays of
+ * structs in parallel.
+ */
+#define RECONSTRUCT_PARALLEL_BYTES_PER_TASK (1 << 16)
+
 /**
  * Converts the contents of an entire struct from oldsdna to newsdna format.
  *
@@ -1256,12 +1263,23 @@ void *DNA_struct_reconstruct(const DNA_ReconstructInfo *reconstruct_info,
   const int alignment = DNA_struct_alignment(newsdna, new_struct_index);
   char *new_blocks = static_cast<char *>(
       MEM_calloc_arrayN_aligned(new_block_size, blocks, alignment, alloc_name));
-  reconstruct_structs(reconstruct_info,
-                      blocks,
-                      old_struct_index,
-                      new_struct_index,
-                      static_cast<const char *>(old_blocks),
-                      new_blocks);
+
+  /* Large arrays of structs (e.g. legacy mesh or custom-data layers) can take a significant part
+   * of the file loading time when they have to be reconstructed. Each element is converted
+   * independently, so split the work over multiple threads. Small blocks are handled on the
+   * calling thread by #threading::parallel_for. */
+  const int old_block_size = oldsdna->types_size[old_struct->type_index];
+  const int64_t grain_size = std::max<int64_t>(
+      1, RECONSTRUCT_PARALLEL_BYTES_PER_TASK / std::max(old_block_size, new_block_size));
+  threading::parallel_for(IndexRange(blocks), grain_size, [&](const IndexRange range) {
+    reconstruct_structs(reconstruct_info,
+                        int(range.size()),
+                        old_struct_index,
+                        new_struct_index,
+                        static_cast<const char *>(old_blocks) +
+                            range.start() * int64_t(old_block_size),
+                        new_blocks + range.start() * int64_t(new_block_size));
+  });
   return new_blocks;
 }
 
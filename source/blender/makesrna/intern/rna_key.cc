@@ -756,8 +756,20 @@ static void rna_Key_update_data(Main *bmain, Scene * /*scene*/, PointerRNA *ptr)
   }
 }
 
+/**
+ * Update for settings that don't change the shape key data, so that the evaluated copy of the key
+ * doesn't have to be duplicated entirely. The generic copy-on-evaluation tag is disabled with
+ * #PROP_NO_DEG_UPDATE for these properties.
+ */
+static void rna_Key_update_settings(Main *bmain, Scene *scene, PointerRNA *ptr)
+{
+  DEG_id_tag_update(ptr->owner_id, ID_RECALC_PARAMETERS);
+  rna_Key_update_data(bmain, scene, ptr);
+}
+
 static void rna_ShapeKey_update_minmax(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
+  DEG_id_tag_update(ptr->owner_id, ID_RECALC_PARAMETERS);
   KeyBlock *data = static_cast<KeyBlock *>(ptr->data);
   if (IN_RANGE_INCL(data->curval, data->slidermin, data->slidermax)) {
     return;
@@ -1004,18 +1016,21 @@ static void rna_def_keyblock(BlenderRNA *brna)
       prop, nullptr, "rna_ShapeKey_value_set", "rna_ShapeKey_value_range");
   RNA_def_property_ui_range(prop, -10.0f, 10.0f, 10, 3);
   RNA_def_property_ui_text(prop, "Value", "Value of shape key at the current frame");
-  RNA_def_property_update(prop, ND_KEYS, "rna_Key_update_data");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+  RNA_def_property_update(prop, ND_KEYS, "rna_Key_update_settings");
 
   prop = RNA_def_property(srna, "interpolation", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_sdna(prop, nullptr, "type");
   RNA_def_property_enum_items(prop, rna_enum_keyblock_type_items);
   RNA_def_property_ui_text(prop, "Interpolation", "Interpolation type for absolute shape keys");
-  RNA_def_property_update(prop, 0, "rna_Key_update_data");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+  RNA_def_property_update(prop, 0, "rna_Key_update_settings");
 
   prop = RNA_def_property(srna, "vertex_group", PROP_STRING, PROP_NONE);
   RNA_def_property_string_sdna(prop, nullptr, "vgroup");
   RNA_def_property_ui_text(prop, "Vertex Group", "Vertex weight group, to blend with basis shape");
-  RNA_def_property_update(prop, 0, "rna_Key_update_data");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+  RNA_def_property_update(prop, 0, "rna_Key_update_settings");
 
   prop = RNA_def_property(srna, "relative_key", PROP_POINTER, PROP_NONE);
   RNA_def_property_struct_type(prop, "ShapeKey");
@@ -1023,14 +1038,16 @@ static void rna_def_keyblock(BlenderRNA *brna)
   RNA_def_property_pointer_funcs(
       prop, "rna_ShapeKey_relative_key_get", "rna_ShapeKey_relative_key_set", nullptr, nullptr);
   RNA_def_property_ui_text(prop, "Relative Key", "Shape used as a relative key");
-  RNA_def_property_update(prop, 0, "rna_Key_update_data");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+  RNA_def_property_update(prop, 0, "rna_Key_update_settings");
 
   prop = RNA_def_property(srna, "mute", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "flag", KEYBLOCK_MUTE);
   RNA_def_property_override_flag(prop, PROPOVERRIDE_OVERRIDABLE_LIBRARY);
   RNA_def_property_ui_text(prop, "Mute", "Toggle this shape key");
   RNA_def_property_ui_icon(prop, ICON_CHECKBOX_HLT, -1);
-  RNA_def_property_update(prop, 0, "rna_Key_update_data");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+  RNA_def_property_update(prop, 0, "rna_Key_update_settings");
 
   prop = RNA_def_property(srna, "lock_shape", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "flag", KEYBLOCK_LOCKED_SHAPE);
@@ -1045,6 +1062,7 @@ static void rna_def_keyblock(BlenderRNA *brna)
   RNA_def_property_float_funcs(
       prop, nullptr, "rna_ShapeKey_slider_min_set", "rna_ShapeKey_slider_min_range");
   RNA_def_property_ui_text(prop, "Slider Min", "Minimum for slider");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
   RNA_def_property_update(prop, 0, "rna_ShapeKey_update_minmax");
 
   prop = RNA_def_property(srna, "slider_max", PROP_FLOAT, PROP_NONE);
@@ -1054,6 +1072,7 @@ static void rna_def_keyblock(BlenderRNA *brna)
   RNA_def_property_float_funcs(
       prop, nullptr, "rna_ShapeKey_slider_max_set", "rna_ShapeKey_slider_max_range");
   RNA_def_property_ui_text(prop, "Slider Max", "Maximum for slider");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
   RNA_def_property_update(prop, 0, "rna_ShapeKey_update_minmax");
 
   prop = RNA_def_property(srna, "data", PROP_COLLECTION, PROP_NONE);
@@ -1169,14 +1188,16 @@ static void rna_def_key(BlenderRNA *brna)
       "Relative",
       "Make shape keys relative, "
       "otherwise play through shapes as a sequence using the evaluation time");
-  RNA_def_property_update(prop, 0, "rna_Key_update_data");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+  RNA_def_property_update(prop, 0, "rna_Key_update_settings");
 
   prop = RNA_def_property(srna, "eval_time", PROP_FLOAT, PROP_NONE);
   RNA_def_property_float_sdna(prop, nullptr, "ctime");
   RNA_def_property_range(prop, MINFRAME, MAXFRAME);
   RNA_def_property_override_flag(prop, PROPOVERRIDE_OVERRIDABLE_LIBRARY);
   RNA_def_property_ui_text(prop, "Evaluation Time", "Evaluation time for absolute shape keys");
-  RNA_def_property_update(prop, 0, "rna_Key_update_data");
+  RNA_def_property_flag(prop, PROP_NO_DEG_UPDATE);
+  RNA_def_property_update(prop, 0, "rna_Key_update_settings");
 }
 
 void RNA_def_key(BlenderRNA *brna)
@@ -7169,6 +7169,14 @@ static void rna_def_userdef_filepaths(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Compress File", "Enable file compression when saving .blend files");
 
+  prop = RNA_def_property(srna, "file_compression_level", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "file_compression_level");
+  RNA_def_property_range(prop, 1, 19);
+  RNA_def_property_ui_text(prop,
+                           "Compression Level",
+                           "Compression level used when saving compressed .blend files, higher "
+                           "levels give smaller files but take more time to save");
+
   prop = RNA_def_property(srna, "use_load_ui", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, nullptr, "flag", USER_FILENOUI);
   RNA_def_property_ui_text(prop, "Load UI", "Load user interface setup when loading .blend files");
@@ -7490,6 +7498,14 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_flag(prop, PROP_CONTEXT_UPDATE);
   RNA_def_property_update(prop, 0, "rna_experimental_no_data_block_packing_update");
 
+  prop = RNA_def_property(srna, "no_evaluated_mesh_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "no_evaluated_mesh_cache", 1);
+  RNA_def_property_ui_text(prop,
+                           "No Evaluated Mesh Cache",
+                           "Evaluate mesh modifier stacks every time, instead of reusing results "
+                           "stored in the memory cache");
+  RNA_def_property_update(prop, 0, "rna_userdef_update");
+
   prop = RNA_def_property(srna, "use_all_linked_data_direct", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(
       prop,
@@ -11,6 +11,7 @@
 #include "UI_resources.hh"
 
 #include "BLI_array_utils.hh"
+#include "BLI_sort.hh"
 
 #include "NOD_socket_search_link.hh"
 
@@ -185,7 +186,7 @@ static void node_geo_exec(GeoNodeExecParams params)
 
       if (data.size() != 0) {
         if (sort_required) {
-          std::sort(data.begin(), data.end());
+          parallel_radix_sort(data.as_mutable_span());
           median = median_of_sorted_span(data);
 
           min = data.first();
@@ -277,9 +278,9 @@ static void node_geo_exec(GeoNodeExecParams params)
 
       if (data.size() != 0) {
         if (sort_required) {
-          std::sort(data_x.begin(), data_x.end());
-          std::sort(data_y.begin(), data_y.end());
-          std::sort(data_z.begin(), data_z.end());
+          parallel_radix_sort(data_x.as_mutable_span());
+          parallel_radix_sort(data_y.as_mutable_span());
+          parallel_radix_sort(data_z.as_mutable_span());
 
           const float x_median = median_of_sorted_span(data_x);
           const float y_median = median_of_sorted_span(data_y);
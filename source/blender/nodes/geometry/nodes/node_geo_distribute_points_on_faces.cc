@@ -155,16 +155,7 @@ static void sample_mesh_surface(const Mesh &mesh,
 
 BLI_NOINLINE static KDTree_3d *build_kdtree(Span<float3> positions)
 {
-  KDTree_3d *kdtree = kdtree_3d_new(positions.size());
-
-  int i_point = 0;
-  for (const float3 position : positions) {
-    kdtree_3d_insert(kdtree, i_point, position);
-    i_point++;
-  }
-
-  kdtree_3d_balance(kdtree);
-  return kdtree;
+  return kdtree_3d_new_from_positions(positions, positions.index_range());
 }
 
 BLI_NOINLINE static void update_elimination_mask_for_close_points(
@@ -25,10 +25,7 @@ static void node_declare(NodeDeclarationBuilder &b)
 
 static KDTree_3d *build_kdtree(const Span<float3> positions, const IndexMask &mask)
 {
-  KDTree_3d *tree = kdtree_3d_new(mask.size());
-  mask.foreach_index([&](const int index) { kdtree_3d_insert(tree, index, positions[index]); });
-  kdtree_3d_balance(tree);
-  return tree;
+  return kdtree_3d_new_from_positions(positions, mask);
 }
 
 static int find_nearest_non_self(const KDTree_3d &tree, const float3 &position, const int index)
@@ -133,22 +133,27 @@ static void raycast_to_mesh(const IndexMask &mask,
     return;
   }
 
+  Array<BVHTreeRayHit> hits(mask.min_array_size());
+  mask.foreach_index([&](const int i) {
+    hits[i].index = -1;
+    hits[i].dist = ray_lengths[i];
+  });
+
+  BLI_bvhtree_ray_cast_batch(
+      *tree_data.tree,
+      mask,
+      VArraySpan<float3>(ray_origins),
+      VArraySpan<float3>(ray_directions),
+      0.0f,
+      hits,
+      [&](const int index, const BVHTreeRay &ray, BVHTreeRayHit &hit) {
+        tree_data.raycast_callback(&tree_data, index, &ray, &hit);
+      });
+
   mask.foreach_index([&](const int i) {
     const float ray_length = ray_lengths[i];
-    const float3 ray_origin = ray_origins[i];
-    const float3 ray_direction = ray_directions[i];
-
-    BVHTreeRayHit hit;
-    hit.index = -1;
-    hit.dist = ray_length;
-    if (BLI_bvhtree_ray_cast(tree_data.tree,
-                             ray_origin,
-                             ray_direction,
-                             0.0f,
-                             &hit,
-                             tree_data.raycast_callback,
-                             &tree_data) != -1)
-    {
+    const BVHTreeRayHit &hit = hits[i];
+    if (hit.index != -1) {
       if (!r_hit.is_empty()) {
         r_hit[i] = hit.index >= 0;
       }
@@ -184,6 +184,7 @@ static CLG_LogRef LOG = {"blend"};
 void WM_file_tag_modified()
 {
   wmWindowManager *wm = static_cast<wmWindowManager *>(G_MAIN->wm.first);
+  wm->runtime->autosave_has_changes = true;
   if (wm->file_saved) {
     wm->file_saved = 0;
     /* Notifier that data changed, for save-over warning or header. */
@@ -896,6 +897,7 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
 {
   double duration_whole_minutes, duration_whole_seconds;
   double duration_libraries_minutes, duration_libraries_seconds;
+  double duration_versioning_minutes, duration_versioning_seconds;
   double duration_lib_override_minutes, duration_lib_override_seconds;
   double duration_lib_override_resync_minutes, duration_lib_override_resync_seconds;
   double duration_lib_override_recursive_resync_minutes,
@@ -913,6 +915,12 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
                                   &duration_libraries_minutes,
                                   &duration_libraries_seconds,
                                   nullptr);
+  BLI_math_time_seconds_decompose(bf_reports->duration.versioning,
+                                  nullptr,
+                                  nullptr,
+                                  &duration_versioning_minutes,
+                                  &duration_versioning_seconds,
+                                  nullptr);
   BLI_math_time_seconds_decompose(bf_reports->duration.lib_overrides,
                                   nullptr,
                                   nullptr,
@@ -938,6 +946,10 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
             " * Loading libraries: %.0fm%.2fs",
             duration_libraries_minutes,
             duration_libraries_seconds);
+  CLOG_INFO(&LOG,
+            " * Versioning: %.0fm%.2fs",
+            duration_versioning_minutes,
+            duration_versioning_seconds);
   CLOG_INFO(&LOG,
             " * Applying overrides: %.0fm%.2fs",
             duration_lib_override_minutes,
@@ -2293,6 +2305,11 @@ static bool wm_autosave_write_try(Main *bmain, wmWindowManager *wm)
     /* When file is already saved, skip creating an auto-save file, see: #146003 */
     return true;
   }
+  if (!wm->runtime->autosave_has_changes) {
+    /* Nothing changed since the last auto-save, the existing file is still up to date. Rewriting
+     * the whole file would only stall the user, especially with large scenes. */
+    return true;
+  }
 
   char filepath[FILE_MAX];
   wm_autosave_location(filepath);
@@ -2330,7 +2347,9 @@ void WM_autosave_write(wmWindowManager *wm, Main *bmain)
 
   /* Error reporting into console. */
   BlendFileWriteParams params{};
-  BLO_write_file(bmain, filepath, fileflags, &params, nullptr);
+  if (BLO_write_file(bmain, filepath, fileflags, &params, nullptr)) {
+    wm->runtime->autosave_has_changes = false;
+  }
 
   /* Restart auto-save timer. */
   wm_autosave_timer_end(wm);
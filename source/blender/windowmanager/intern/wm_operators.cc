@@ -45,6 +45,7 @@
 #include "BLI_math_vector.h"
 #include "BLI_math_vector_types.hh"
 #include "BLI_path_utils.hh"
+#include "BLI_scratch_allocator.hh"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
 #include "BLI_time.h"
@@ -3865,6 +3866,8 @@ static void WM_OT_redraw_timer(wmOperatorType *ot)
 static wmOperatorStatus memory_statistics_exec(bContext * /*C*/, wmOperator * /*op*/)
 {
   MEM_printmemlist_stats();
+  printf("scratch memory len: %.3f MB\n",
+         double(scratch_allocator_memory_in_use()) / double(1024 * 1024));
   return OPERATOR_FINISHED;
 }
 